@@ -299,13 +299,22 @@
 #endif // end of #if defined(__MAC_OS_X_VERSION_MIN_REQUIRED)
 
 // next redefinitions required since SDK 7
-#include <CoreFoundation/CFAvailability.h>
+// Every CF_ availability macro goes through __OSX_AVAILABLE_STARTING, i.e. through the
+// __AVAILABILITY_INTERNAL__ macros redefined above. CF_ENUM_* expand to these, and
+// CF_EXTENSION_UNAVAILABLE* carry no version. CF_DEPRECATED* keep their stock attribute,
+// deprecation message included, after that check.
 #undef CF_AVAILABLE
 #define CF_AVAILABLE(_mac, _ios) __OSX_AVAILABLE_STARTING(__MAC_##_mac, __IPHONE_##_ios)
 #undef CF_AVAILABLE_MAC
 #define CF_AVAILABLE_MAC(_mac) __OSX_AVAILABLE_STARTING(__MAC_##_mac, __IPHONE_NA)
 #undef CF_AVAILABLE_IOS
 #define CF_AVAILABLE_IOS(_ios) __OSX_AVAILABLE_STARTING(__MAC_NA, __IPHONE_##_ios)
+#undef CF_DEPRECATED
+#define CF_DEPRECATED(_macIntro, _macDep, _iosIntro, _iosDep, ...) CF_AVAILABLE(_macIntro, _iosIntro) __attribute__((availability(ios,introduced=_iosIntro,deprecated=_iosDep,message="" __VA_ARGS__)))
+#undef CF_DEPRECATED_MAC
+#define CF_DEPRECATED_MAC(_macIntro, _macDep, ...) CF_AVAILABLE_MAC(_macIntro) __attribute__((availability(ios,unavailable)))
+#undef CF_DEPRECATED_IOS
+#define CF_DEPRECATED_IOS(_iosIntro, _iosDep, ...) CF_AVAILABLE_IOS(_iosIntro) __attribute__((availability(ios,introduced=_iosIntro,deprecated=_iosDep,message="" __VA_ARGS__)))
 
 //
 //  MJGAvailability end
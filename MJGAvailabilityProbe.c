@@ -0,0 +1,81 @@
+//
+//  MJGAvailabilityProbe.c
+//
+//  Lookup cache behind MJGAvailabilityProbe.h. Compile as Objective-C to get
+//  MJGAvailabilityRespondsToSelector.
+//
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // RTLD_DEFAULT on glibc
+#endif
+
+#include <dlfcn.h>
+#include <stdint.h>
+
+#include "MJGAvailabilityProbe.h"
+
+// Open addressing table, never resized nor cleared: availability doesn't change while the
+// process runs. A slot goes EMPTY -> WRITING -> READY once, claimed with a compare and swap, so
+// readers never lock. When a probe sequence is full or still being written, the lookup is just
+// resolved again without caching.
+#define MJG_SLOT_COUNT 4096
+#define MJG_MAX_PROBES 16
+
+enum {
+    MJG_SLOT_EMPTY,
+    MJG_SLOT_WRITING,
+    MJG_SLOT_READY
+};
+
+typedef struct {
+    const void *key;
+    const void *subkey;
+    void *value;
+    int state;
+} MJGAvailabilitySlot;
+
+static MJGAvailabilitySlot mjg_slots[MJG_SLOT_COUNT];
+
+typedef void *(*MJGAvailabilityResolver)(const void *key, const void *subkey);
+
+static void *mjg_cached(const void *key, const void *subkey, MJGAvailabilityResolver resolve) {
+    uintptr_t hash = ((uintptr_t)key ^ ((uintptr_t)subkey * 31)) * (uintptr_t)0x9E3779B97F4A7C15ull;
+    hash ^= hash >> 17;
+    for (int probe = 0; probe < MJG_MAX_PROBES; probe++) {
+        MJGAvailabilitySlot *slot = &mjg_slots[(hash + probe) & (MJG_SLOT_COUNT - 1)];
+        int state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+        if (state == MJG_SLOT_EMPTY
+            && __atomic_compare_exchange_n(&slot->state, &state, MJG_SLOT_WRITING, 0,
+                                           __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            void *value = resolve(key, subkey);
+            slot->key = key;
+            slot->subkey = subkey;
+            slot->value = value;
+            __atomic_store_n(&slot->state, MJG_SLOT_READY, __ATOMIC_RELEASE);
+            return value;
+        }
+        if (state == MJG_SLOT_READY && slot->key == key && slot->subkey == subkey) {
+            return slot->value;
+        }
+    }
+    return resolve(key, subkey);
+}
+
+static void *mjg_resolve_symbol(const void *name, const void *unused) {
+    (void)unused;
+    return dlsym(RTLD_DEFAULT, (const char *)name);
+}
+
+void *MJGAvailabilityLookup(const char *name) {
+    return mjg_cached(name, 0, mjg_resolve_symbol);
+}
+
+#ifdef __OBJC__
+static void *mjg_resolve_selector(const void *cls, const void *selector) {
+    return class_respondsToSelector((__bridge Class)cls, (SEL)selector) ? (void *)(uintptr_t)1 : 0;
+}
+
+BOOL MJGAvailabilityRespondsToSelector(Class cls, SEL selector) {
+    return mjg_cached((__bridge const void *)cls, selector, mjg_resolve_selector) != 0;
+}
+#endif
@@ -0,0 +1,90 @@
+//
+//  MJGAvailabilityProbe.h
+//
+//  Runtime checks for the APIs MJGAvailability.h flags as too new. Add MJGAvailabilityProbe.c
+//  to your target.
+//
+//  Weak imported symbols are bound by the dynamic loader when the image loads, so
+//  API_IS_AVAILABLE is a plain NULL check. Lookups by name and respondsToSelector: are resolved
+//  once, then served from a per call site slot or from a lock-free table shared by all threads.
+//
+
+#ifndef MJG_AVAILABILITY_PROBE_H
+#define MJG_AVAILABILITY_PROBE_H
+
+#ifdef __OBJC__
+#import <objc/runtime.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MJG_AVAILABILITY_UNRESOLVED ((void *)1)
+
+/**
+* Address of the global symbol name, NULL when the running OS doesn't have it. Resolved with
+* dlsym once per name, then cached. Pass a string literal: the table is keyed on its address.
+*/
+void *MJGAvailabilityLookup(const char *name);
+
+#ifdef __OBJC__
+/**
+* class_respondsToSelector, resolved once per class and selector.
+*/
+BOOL MJGAvailabilityRespondsToSelector(Class cls, SEL selector);
+#endif
+
+static inline int MJGAvailabilityCachedLookup(void **slot, const char *name) {
+    void *address = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+    if (address == MJG_AVAILABILITY_UNRESOLVED) {
+        address = MJGAvailabilityLookup(name);
+        __atomic_store_n(slot, address, __ATOMIC_RELEASE);
+    }
+    return address != 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+* Example usage:
+*
+*   if (API_IS_AVAILABLE(CFURLCreateWithFileSystemPath)) {
+*       url = CFURLCreateWithFileSystemPath(...);
+*   }
+*
+*   if (API_SYMBOL_IS_AVAILABLE("CFURLCreateWithFileSystemPath")) { ... }
+*
+*   if (API_RESPONDS_TO_SELECTOR(navBar, setBackgroundImage:forBarMetrics:)) {
+*       [navBar setBackgroundImage:image forBarMetrics:UIBarMetricsDefault];
+*   }
+*
+* checkAvailability.sh treats API_IS_AVAILABLE and API_RESPONDS_TO_SELECTOR conditions as guards.
+*/
+
+// Whether the weak imported function or variable sym exists at runtime, without a too new warning.
+#define API_IS_AVAILABLE(sym) \
+    (__extension__ ({ \
+        _Pragma("GCC diagnostic push") \
+        _Pragma("GCC diagnostic ignored \"-Wdeprecated-declarations\"") \
+        int mjg_available = &(sym) != 0; \
+        _Pragma("GCC diagnostic pop") \
+        mjg_available; \
+    }))
+
+// Whether the global symbol called name exists at runtime, looked up once per call site.
+#define API_SYMBOL_IS_AVAILABLE(name) \
+    (__extension__ ({ \
+        static void *mjg_address = MJG_AVAILABILITY_UNRESOLVED; \
+        MJGAvailabilityCachedLookup(&mjg_address, (name)); \
+    }))
+
+#ifdef __OBJC__
+// respondsToSelector: without a message send once the class and selector were seen.
+#define API_RESPONDS_TO_SELECTOR(object, sel) \
+    MJGAvailabilityRespondsToSelector(object_getClass(object), @selector(sel))
+#endif
+
+#endif
@@ -0,0 +1,460 @@
+//
+//  MJGAvailabilityTable.hpp
+//
+//  Generated by generateAvailabilityTable.sh, do not edit.
+//
+//  The iOS / OS X version table as C++17 constants, checked against the soft max in templates
+//  instead of through the __IPHONE_##_ios / __MAC_##_mac macro chain. Doesn't include
+//  Availability.h; the soft max comes from -D__IPHONE_OS_VERSION_SOFT_MAX_REQUIRED=<value>
+//  (resp. __MAC_OS_X_VERSION_SOFT_MAX_REQUIRED), e.g. 80000 or __IPHONE_8_0, else from the
+//  deployment target clang predefines.
+//
+//  Example usage:
+//
+//    using namespace mjg::availability;
+//
+//    require<Platform::iOS, ios::v9_0>();         // too new: deprecation warning, like the hack
+//    require_strict<Platform::iOS, ios::v9_0>();  // too new: compile error
+//    if constexpr (is_available<Platform::iOS, ios::v9_0>) { ... }
+//
+
+#ifndef MJG_AVAILABILITY_TABLE_HPP
+#define MJG_AVAILABILITY_TABLE_HPP
+
+namespace mjg {
+namespace availability {
+
+enum class Platform { iOS, OSX };
+
+// Packed as in Availability.h: 80000 for iOS 8.0, 1090 for OS X 10.9, 101000 for OS X 10.10.
+using Version = unsigned long;
+
+namespace ios {
+inline constexpr Version v2_0 = 20000;
+inline constexpr Version v2_1 = 20100;
+inline constexpr Version v2_2 = 20200;
+inline constexpr Version v3_0 = 30000;
+inline constexpr Version v3_1 = 30100;
+inline constexpr Version v3_2 = 30200;
+inline constexpr Version v4_0 = 40000;
+inline constexpr Version v4_1 = 40100;
+inline constexpr Version v4_2 = 40200;
+inline constexpr Version v4_3 = 40300;
+inline constexpr Version v5_0 = 50000;
+inline constexpr Version v5_1 = 50100;
+inline constexpr Version v6_0 = 60000;
+inline constexpr Version v6_1 = 60100;
+inline constexpr Version v7_0 = 70000;
+inline constexpr Version v7_1 = 70100;
+inline constexpr Version v8_0 = 80000;
+inline constexpr Version v8_1 = 80100;
+inline constexpr Version v8_2 = 80200;
+inline constexpr Version v8_3 = 80300;
+inline constexpr Version v8_4 = 80400;
+inline constexpr Version v9_0 = 90000;
+inline constexpr Version v9_1 = 90100;
+inline constexpr Version all[] = {
+    v2_0,
+    v2_1,
+    v2_2,
+    v3_0,
+    v3_1,
+    v3_2,
+    v4_0,
+    v4_1,
+    v4_2,
+    v4_3,
+    v5_0,
+    v5_1,
+    v6_0,
+    v6_1,
+    v7_0,
+    v7_1,
+    v8_0,
+    v8_1,
+    v8_2,
+    v8_3,
+    v8_4,
+    v9_0,
+    v9_1,
+};
+} // namespace ios
+
+namespace osx {
+inline constexpr Version v10_0 = 1000;
+inline constexpr Version v10_1 = 1010;
+inline constexpr Version v10_2 = 1020;
+inline constexpr Version v10_3 = 1030;
+inline constexpr Version v10_4 = 1040;
+inline constexpr Version v10_5 = 1050;
+inline constexpr Version v10_6 = 1060;
+inline constexpr Version v10_7 = 1070;
+inline constexpr Version v10_8 = 1080;
+inline constexpr Version v10_9 = 1090;
+inline constexpr Version v10_10 = 101000;
+inline constexpr Version v10_11 = 101100;
+inline constexpr Version all[] = {
+    v10_0,
+    v10_1,
+    v10_2,
+    v10_3,
+    v10_4,
+    v10_5,
+    v10_6,
+    v10_7,
+    v10_8,
+    v10_9,
+    v10_10,
+    v10_11,
+};
+} // namespace osx
+
+// The soft max may be spelled with the constants of Availability.h, which isn't included.
+#ifndef __IPHONE_2_0
+#define __IPHONE_2_0 20000
+#endif
+#ifndef __IPHONE_2_1
+#define __IPHONE_2_1 20100
+#endif
+#ifndef __IPHONE_2_2
+#define __IPHONE_2_2 20200
+#endif
+#ifndef __IPHONE_3_0
+#define __IPHONE_3_0 30000
+#endif
+#ifndef __IPHONE_3_1
+#define __IPHONE_3_1 30100
+#endif
+#ifndef __IPHONE_3_2
+#define __IPHONE_3_2 30200
+#endif
+#ifndef __IPHONE_4_0
+#define __IPHONE_4_0 40000
+#endif
+#ifndef __IPHONE_4_1
+#define __IPHONE_4_1 40100
+#endif
+#ifndef __IPHONE_4_2
+#define __IPHONE_4_2 40200
+#endif
+#ifndef __IPHONE_4_3
+#define __IPHONE_4_3 40300
+#endif
+#ifndef __IPHONE_5_0
+#define __IPHONE_5_0 50000
+#endif
+#ifndef __IPHONE_5_1
+#define __IPHONE_5_1 50100
+#endif
+#ifndef __IPHONE_6_0
+#define __IPHONE_6_0 60000
+#endif
+#ifndef __IPHONE_6_1
+#define __IPHONE_6_1 60100
+#endif
+#ifndef __IPHONE_7_0
+#define __IPHONE_7_0 70000
+#endif
+#ifndef __IPHONE_7_1
+#define __IPHONE_7_1 70100
+#endif
+#ifndef __IPHONE_8_0
+#define __IPHONE_8_0 80000
+#endif
+#ifndef __IPHONE_8_1
+#define __IPHONE_8_1 80100
+#endif
+#ifndef __IPHONE_8_2
+#define __IPHONE_8_2 80200
+#endif
+#ifndef __IPHONE_8_3
+#define __IPHONE_8_3 80300
+#endif
+#ifndef __IPHONE_8_4
+#define __IPHONE_8_4 80400
+#endif
+#ifndef __IPHONE_9_0
+#define __IPHONE_9_0 90000
+#endif
+#ifndef __IPHONE_9_1
+#define __IPHONE_9_1 90100
+#endif
+#ifndef __MAC_10_0
+#define __MAC_10_0 1000
+#endif
+#ifndef __MAC_10_1
+#define __MAC_10_1 1010
+#endif
+#ifndef __MAC_10_2
+#define __MAC_10_2 1020
+#endif
+#ifndef __MAC_10_3
+#define __MAC_10_3 1030
+#endif
+#ifndef __MAC_10_4
+#define __MAC_10_4 1040
+#endif
+#ifndef __MAC_10_5
+#define __MAC_10_5 1050
+#endif
+#ifndef __MAC_10_6
+#define __MAC_10_6 1060
+#endif
+#ifndef __MAC_10_7
+#define __MAC_10_7 1070
+#endif
+#ifndef __MAC_10_8
+#define __MAC_10_8 1080
+#endif
+#ifndef __MAC_10_9
+#define __MAC_10_9 1090
+#endif
+#ifndef __MAC_10_10
+#define __MAC_10_10 101000
+#endif
+#ifndef __MAC_10_11
+#define __MAC_10_11 101100
+#endif
+
+#if defined(__IPHONE_OS_VERSION_SOFT_MAX_REQUIRED)
+#define MJG_AVAILABILITY_IPHONE_SOFT_MAX __IPHONE_OS_VERSION_SOFT_MAX_REQUIRED
+#elif defined(__ENVIRONMENT_IPHONE_OS_VERSION_MIN_REQUIRED__)
+#define MJG_AVAILABILITY_IPHONE_SOFT_MAX __ENVIRONMENT_IPHONE_OS_VERSION_MIN_REQUIRED__
+#else
+#define MJG_AVAILABILITY_IPHONE_SOFT_MAX 0 // not targeting iOS, nothing is too new
+#endif
+
+#if defined(__MAC_OS_X_VERSION_SOFT_MAX_REQUIRED)
+#define MJG_AVAILABILITY_MAC_SOFT_MAX __MAC_OS_X_VERSION_SOFT_MAX_REQUIRED
+#elif defined(__ENVIRONMENT_MAC_OS_X_VERSION_MIN_REQUIRED__)
+#define MJG_AVAILABILITY_MAC_SOFT_MAX __ENVIRONMENT_MAC_OS_X_VERSION_MIN_REQUIRED__
+#else
+#define MJG_AVAILABILITY_MAC_SOFT_MAX 0
+#endif
+
+inline constexpr Version ios_soft_max = MJG_AVAILABILITY_IPHONE_SOFT_MAX;
+inline constexpr Version osx_soft_max = MJG_AVAILABILITY_MAC_SOFT_MAX;
+
+constexpr Version soft_max(Platform platform) {
+    return platform == Platform::iOS ? ios_soft_max : osx_soft_max;
+}
+
+template <class Table>
+constexpr bool contains(const Table &table, Version version) {
+    for (Version known : table) {
+        if (known == version) {
+            return true;
+        }
+    }
+    return false;
+}
+
+constexpr bool known(Platform platform, Version version) {
+    return platform == Platform::iOS ? contains(ios::all, version) : contains(osx::all, version);
+}
+
+constexpr bool too_new(Platform platform, Version version) {
+    return soft_max(platform) != 0 && version > soft_max(platform);
+}
+
+template <Platform P, Version V>
+struct checked {
+    static_assert(known(P, V), "Unknown version, regenerate MJGAvailabilityTable.hpp");
+    static constexpr bool available = !too_new(P, V);
+};
+
+template <Platform P, Version V>
+inline constexpr bool is_available = checked<P, V>::available;
+
+// always_inline so that even -O0 builds don't emit a call. The versions above the soft max
+// are deprecated specializations, below.
+template <Platform P, Version V>
+[[gnu::always_inline]] constexpr void require() noexcept {
+    static_assert(known(P, V), "Unknown version, regenerate MJGAvailabilityTable.hpp");
+}
+
+template <Platform P, Version V>
+[[gnu::always_inline]] constexpr void require_strict() noexcept {
+    static_assert(is_available<P, V>, "API only available after the soft max");
+}
+
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 20000
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 2.0, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v2_0>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 20100
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 2.1, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v2_1>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 20200
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 2.2, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v2_2>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 30000
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 3.0, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v3_0>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 30100
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 3.1, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v3_1>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 30200
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 3.2, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v3_2>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 40000
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 4.0, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v4_0>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 40100
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 4.1, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v4_1>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 40200
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 4.2, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v4_2>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 40300
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 4.3, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v4_3>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 50000
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 5.0, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v5_0>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 50100
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 5.1, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v5_1>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 60000
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 6.0, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v6_0>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 60100
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 6.1, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v6_1>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 70000
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 7.0, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v7_0>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 70100
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 7.1, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v7_1>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 80000
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 8.0, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v8_0>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 80100
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 8.1, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v8_1>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 80200
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 8.2, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v8_2>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 80300
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 8.3, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v8_3>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 80400
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 8.4, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v8_4>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 90000
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 9.0, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v9_0>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_IPHONE_SOFT_MAX != 0 && MJG_AVAILABILITY_IPHONE_SOFT_MAX < 90100
+template <>
+[[gnu::always_inline, deprecated("API only available from iOS 9.1, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::iOS, ios::v9_1>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_MAC_SOFT_MAX != 0 && MJG_AVAILABILITY_MAC_SOFT_MAX < 1000
+template <>
+[[gnu::always_inline, deprecated("API only available from OS X 10.0, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::OSX, osx::v10_0>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_MAC_SOFT_MAX != 0 && MJG_AVAILABILITY_MAC_SOFT_MAX < 1010
+template <>
+[[gnu::always_inline, deprecated("API only available from OS X 10.1, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::OSX, osx::v10_1>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_MAC_SOFT_MAX != 0 && MJG_AVAILABILITY_MAC_SOFT_MAX < 1020
+template <>
+[[gnu::always_inline, deprecated("API only available from OS X 10.2, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::OSX, osx::v10_2>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_MAC_SOFT_MAX != 0 && MJG_AVAILABILITY_MAC_SOFT_MAX < 1030
+template <>
+[[gnu::always_inline, deprecated("API only available from OS X 10.3, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::OSX, osx::v10_3>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_MAC_SOFT_MAX != 0 && MJG_AVAILABILITY_MAC_SOFT_MAX < 1040
+template <>
+[[gnu::always_inline, deprecated("API only available from OS X 10.4, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::OSX, osx::v10_4>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_MAC_SOFT_MAX != 0 && MJG_AVAILABILITY_MAC_SOFT_MAX < 1050
+template <>
+[[gnu::always_inline, deprecated("API only available from OS X 10.5, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::OSX, osx::v10_5>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_MAC_SOFT_MAX != 0 && MJG_AVAILABILITY_MAC_SOFT_MAX < 1060
+template <>
+[[gnu::always_inline, deprecated("API only available from OS X 10.6, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::OSX, osx::v10_6>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_MAC_SOFT_MAX != 0 && MJG_AVAILABILITY_MAC_SOFT_MAX < 1070
+template <>
+[[gnu::always_inline, deprecated("API only available from OS X 10.7, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::OSX, osx::v10_7>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_MAC_SOFT_MAX != 0 && MJG_AVAILABILITY_MAC_SOFT_MAX < 1080
+template <>
+[[gnu::always_inline, deprecated("API only available from OS X 10.8, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::OSX, osx::v10_8>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_MAC_SOFT_MAX != 0 && MJG_AVAILABILITY_MAC_SOFT_MAX < 1090
+template <>
+[[gnu::always_inline, deprecated("API only available from OS X 10.9, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::OSX, osx::v10_9>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_MAC_SOFT_MAX != 0 && MJG_AVAILABILITY_MAC_SOFT_MAX < 101000
+template <>
+[[gnu::always_inline, deprecated("API only available from OS X 10.10, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::OSX, osx::v10_10>() noexcept {}
+#endif
+#if MJG_AVAILABILITY_MAC_SOFT_MAX != 0 && MJG_AVAILABILITY_MAC_SOFT_MAX < 101100
+template <>
+[[gnu::always_inline, deprecated("API only available from OS X 10.11, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")]]
+constexpr void require<Platform::OSX, osx::v10_11>() noexcept {}
+#endif
+
+} // namespace availability
+} // namespace mjg
+
+#endif
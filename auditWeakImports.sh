@@ -0,0 +1,101 @@
+#!/bin/bash
+#
+# Audits compiled objects, static archives and dylibs without recompiling: lists their undefined
+# symbols and checks them against the SDK availability index for the deployment target.
+# References the hack marked too new are weak imports, and have to be checked at runtime.
+# Strong references to too-new symbols fail to load on older systems.
+#
+# usage: auditWeakImports.sh [-s SDK] [-x INDEX] [-i IOS_TARGET] [-m MAC_TARGET] [-j JOBS] FILE...
+#
+# NM selects the nm to use (default nm); it must support -A -m -u, as Xcode's nm and llvm-nm do.
+# Exits with 1 when strong references to too-new symbols are found.
+#
+
+set -e
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+. "${SCRIPT_DIR}/availabilityCommon.sh"
+
+SDK=""
+INDEX=""
+IOS_TARGET=""
+MAC_TARGET=""
+JOBS=$(getconf _NPROCESSORS_ONLN)
+NM=${NM:-nm}
+
+while getopts "s:x:i:m:j:" OPTION ; do
+    case $OPTION in
+        s) SDK=$OPTARG ;;
+        x) INDEX=$OPTARG ;;
+        i) IOS_TARGET=$OPTARG ;;
+        m) MAC_TARGET=$OPTARG ;;
+        j) JOBS=$OPTARG ;;
+        *) sed -n '8s/^# //p' "$0" >&2 ; exit 2 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [ $# -eq 0 ] || [ -z "${IOS_TARGET}${MAC_TARGET}" ]; then
+    sed -n '8s/^# //p' "$0" >&2
+    exit 2
+fi
+if [ -z "$SDK" ]; then
+    SDK=$(xcrun --sdk iphoneos --show-sdk-path)
+fi
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+availability_table "$SDK" > "${WORK}/table"
+if [ -z "$INDEX" ]; then
+    INDEX="${WORK}/index"
+    availability_index "$SDK" "$JOBS" > "$INDEX"
+fi
+
+IOS_TARGET=$(availability_soft_max_values IPHONE "$IOS_TARGET" "${WORK}/table") || exit 2
+MAC_TARGET=$(availability_soft_max_values MAC "$MAC_TARGET" "${WORK}/table") || exit 2
+
+TAB=$(printf '\t')
+
+# "<symbol>\t<file[:member]>\t<weak>" for every undefined symbol, C and Objective-C class
+# names unmangled to match the index.
+printf '%s\0' "$@" | xargs -0 -P "$JOBS" -n 8 "$NM" -A -m -u | \
+    awk '
+        / \(undefined\) / {
+            location = $0
+            sub(/:[ \t]+\(undefined\).*/, "", location)
+            # Linked images append " (from <library>)" to the symbol.
+            symbol = $0
+            sub(/.*\(undefined\)( weak)? external[ \t]+/, "", symbol)
+            sub(/[ \t].*/, "", symbol)
+            sub(/^_OBJC_(META)?CLASS_\$_/, "_", symbol)
+            sub(/^_/, "", symbol)
+            print symbol "\t" location "\t" ($0 ~ /\(undefined\) weak external/)
+        }' | \
+    LC_ALL=C sort -u | \
+    LC_ALL=C join -t "$TAB" - "$INDEX" | \
+    awk -F "$TAB" -v ios="$IOS_TARGET" -v mac="$MAC_TARGET" '
+        FILENAME == ARGV[1] {
+            split($0, field, " ")
+            name[field[1], field[3]] = field[2]
+            gsub(/_/, ".", name[field[1], field[3]])
+            next
+        }
+        {
+            target = ($4 == "IPHONE" ? ios : mac) + 0
+            if (target == 0 || $7 || $5 <= target)
+                next
+            label = $4 == "IPHONE" ? "iOS" : "OS X"
+            if ($3) {
+                printf "%s: warning: '\''%s'\'' is weak imported: API only available from %s %s, check it at runtime before use\n",
+                    $2, $1, label, name[$4, $5]
+            } else {
+                printf "%s: error: '\''%s'\'' is strongly referenced: API only available from %s %s, it will fail to load below that\n",
+                    $2, $1, label, name[$4, $5]
+            }
+        }' "${WORK}/table" - | sort > "${WORK}/findings"
+
+cat "${WORK}/findings"
+if grep -q ': error: ' "${WORK}/findings" ; then
+    exit 1
+fi
@@ -0,0 +1,1526 @@
+#!/bin/bash
+#
+# Helpers shared by the availability scripts. Source this file, don't run it.
+#
+
+# availability_headers SDK
+#   Prints the headers of SDK that carry the __IPHONE_x_y / __MAC_x_y version table.
+availability_headers() {
+    local SDK=$1
+    local HEADER
+    for HEADER in Availability.h AvailabilityVersions.h ; do
+        if [ -f "${SDK}/usr/include/${HEADER}" ]; then
+            echo "${SDK}/usr/include/${HEADER}"
+        fi
+    done
+}
+
+# availability_versions PLATFORM FILE...
+#   Prints "<x_y> <value>" for every __<PLATFORM>_x_y macro defined in FILE..., sorted by value.
+#   PLATFORM is IPHONE or MAC.
+availability_versions() {
+    local PLATFORM=$1
+    shift
+    awk -v prefix="__${PLATFORM}_" '
+        $1 == "#define" && index($2, prefix) == 1 && $3 ~ /^[0-9]+$/ {
+            name = substr($2, length(prefix) + 1)
+            if (name ~ /^[0-9]+(_[0-9]+)+$/)
+                print name, $3
+        }' "$@" | sort -n -k2,2 -u
+}
+
+# availability_version_value VERSION TABLE
+#   Resolves VERSION ("8.0", "8_0", "__IPHONE_8_0" or a raw value like 80000) against TABLE,
+#   the output of availability_versions.
+availability_version_value() {
+    local VERSION=$1
+    local TABLE=$2
+    case $VERSION in
+        *[!0-9]*) ;;
+        ????*) echo "$VERSION" ; return 0 ;;
+    esac
+    VERSION=${VERSION#__IPHONE_}
+    VERSION=${VERSION#__MAC_}
+    VERSION=${VERSION//./_}
+    case $VERSION in
+        *_*) ;;
+        *) VERSION=${VERSION}_0 ;;
+    esac
+    awk -v version="$VERSION" '$1 == version { print $2 ; found = 1 } END { exit !found }' <<< "$TABLE"
+}
+
+# availability_soft_max_values PLATFORM VERSION[,VERSION...] TABLE_FILE
+#   Prints the values of the versions, resolved against TABLE_FILE (availability_table output),
+#   as an ascending comma-separated list. Fails on an unknown version.
+availability_soft_max_values() {
+    local TABLE
+    local VERSION
+    local VALUE
+    local VALUES=""
+    TABLE=$(awk -v platform="$1" '$1 == platform { print $2, $3 }' "$3")
+    for VERSION in ${2//,/ } ; do
+        if ! VALUE=$(availability_version_value "$VERSION" "$TABLE"); then
+            echo "Unknown $1 version ${VERSION}" >&2
+            return 1
+        fi
+        VALUES="${VALUES} ${VALUE}"
+    done
+    printf '%s\n' $VALUES | sort -n -u | paste -s -d, -
+}
+
+# availability_sdk_headers SDK
+#   Prints the headers of SDK NUL-separated, for xargs -0.
+availability_sdk_headers() {
+    local SDK=$1
+    local DIR
+    for DIR in "${SDK}/usr/include" "${SDK}/System/Library/Frameworks" ; do
+        if [ -d "$DIR" ]; then
+            find -L "$DIR" -name '*.h' -print0
+        fi
+    done
+}
+
+# availability_table SDK
+#   Prints "<PLATFORM> <x_y> <value>" for both platforms of SDK's version table.
+availability_table() {
+    local SDK=$1
+    local PLATFORM
+    for PLATFORM in IPHONE MAC ; do
+        availability_versions "$PLATFORM" $(availability_headers "$SDK") | sed "s/^/${PLATFORM} /"
+    done
+}
+
+# availability_extract HEADER...
+#   Prints "<symbol>\t<PLATFORM>\t<introduced x_y or NA>\t<deprecated x_y or ->" for every declaration
+#   of HEADER... carrying a CF_/NS_ availability macro, __OSX_AVAILABLE_*, API_AVAILABLE or
+#   __AVAILABILITY_INTERNAL__*.
+availability_extract() {
+    awk '
+        function version(v) {
+            gsub(/[ \t]/, "", v)
+            sub(/^(__)?(IPHONE|MAC)_/, "", v)
+            gsub(/\./, "_", v)
+            return v
+        }
+
+        function record(platform, introduced, deprecated) {
+            count++
+            platforms[count] = platform
+            introduceds[count] = version(introduced)
+            deprecateds[count] = version(deprecated)
+            if (deprecateds[count] == "" || deprecateds[count] == "NA")
+                deprecateds[count] = "-"
+        }
+
+        # Records the availability carried by one macro occurrence.
+        function parse(macro,   head, n, arg, i, platform) {
+            head = macro
+            sub(/[ \t]*\(.*/, "", head)
+            n = 0
+            if (match(macro, /\(.*\)$/)) {
+                n = split(substr(macro, RSTART + 1, RLENGTH - 2), arg, ",")
+            }
+            if (head ~ /^__AVAILABILITY_INTERNAL__/) {
+                sub(/^__AVAILABILITY_INTERNAL__/, "", head)
+                platform = head ~ /^IPHONE/ ? "IPHONE" : "MAC"
+                n = split(head, arg, "_DEP__")
+                record(platform, arg[1], n > 1 ? arg[2] : "")
+            } else if (head == "API_AVAILABLE") {
+                for (i = 1; i <= n; i++) {
+                    if (arg[i] ~ /^[ \t]*ios[ \t]*\(/)
+                        platform = "IPHONE"
+                    else if (arg[i] ~ /^[ \t]*macosx?[ \t]*\(/)
+                        platform = "MAC"
+                    else
+                        continue
+                    sub(/^[^(]*\(/, "", arg[i])
+                    sub(/\).*/, "", arg[i])
+                    record(platform, arg[i], "")
+                }
+            } else if (head == "__IOS_AVAILABLE") {
+                record("IPHONE", arg[1], "")
+            } else if (head == "__OSX_AVAILABLE") {
+                record("MAC", arg[1], "")
+            } else if (head == "__OSX_AVAILABLE_STARTING") {
+                record("MAC", arg[1], "")
+                record("IPHONE", arg[2], "")
+            } else if (head == "__OSX_AVAILABLE_BUT_DEPRECATED") {
+                record("MAC", arg[1], arg[2])
+                record("IPHONE", arg[3], arg[4])
+            } else if (head ~ /DEPRECATED_MAC$/) {
+                record("MAC", arg[1], arg[2])
+            } else if (head ~ /DEPRECATED_(IOS|IPHONE)$/) {
+                record("IPHONE", arg[1], arg[2])
+            } else if (head ~ /DEPRECATED$/) {
+                record("MAC", arg[1], arg[2])
+                record("IPHONE", arg[3], arg[4])
+            } else if (head ~ /AVAILABLE_MAC$/) {
+                record("MAC", arg[1], "")
+            } else if (head ~ /AVAILABLE_(IOS|IPHONE)$/) {
+                record("IPHONE", arg[1], "")
+            } else if (head ~ /AVAILABLE$/) {
+                record("MAC", arg[1], "")
+                record("IPHONE", arg[2], "")
+            }
+        }
+
+        # Name of the declared symbol: class, first selector piece, function, variable or enumerator.
+        function declared_name(d,   i, depth, c) {
+            if (match(d, /@(interface|protocol)[ \t]+[A-Za-z_][A-Za-z0-9_]*/)) {
+                d = substr(d, RSTART, RLENGTH)
+                sub(/^@(interface|protocol)[ \t]+/, "", d)
+                return d
+            }
+            sub(/^[ \t]+/, "", d)
+            if (d ~ /^[-+]/) {
+                sub(/^[-+][ \t]*(\(([^()]|\([^()]*\))*\))?[ \t]*/, "", d)
+                return match(d, /^[A-Za-z_][A-Za-z0-9_]*/) ? substr(d, RSTART, RLENGTH) : ""
+            }
+            sub(/=.*/, "", d)
+            while (1) {
+                sub(/[ \t]+$/, "", d)
+                if (sub(/__attribute__[ \t]*\(\(([^()]|\([^()]*\))*\)\)$/, "", d))
+                    continue
+                if (sub(/[A-Z_][A-Z0-9_]*[ \t]*\([^()]*\)$/, "", d))
+                    continue
+                if (sub(/\)[ \t]+[A-Z_][A-Z0-9_]*$/, ")", d))
+                    continue
+                break
+            }
+            sub(/(\[[^]]*\])+$/, "", d)
+            if (d ~ /\)$/) {
+                depth = 0
+                for (i = length(d); i > 0; i--) {
+                    c = substr(d, i, 1)
+                    if (c == ")")
+                        depth++
+                    else if (c == "(" && --depth == 0)
+                        break
+                }
+                d = substr(d, 1, i - 1)
+                sub(/[ \t]+$/, "", d)
+                if (d ~ /\)$/)
+                    gsub(/[()*]/, " ", d)
+                sub(/[ \t]+$/, "", d)
+            }
+            return match(d, /[A-Za-z_][A-Za-z0-9_]*$/) ? substr(d, RSTART, RLENGTH) : ""
+        }
+
+        function statement(s,   decl, name, i, macro) {
+            count = 0
+            decl = s
+            while (match(s, MACRO)) {
+                macro = substr(s, RSTART, RLENGTH)
+                s = substr(s, RSTART + RLENGTH)
+                parse(macro)
+            }
+            if (count == 0)
+                return
+            gsub(MACRO, " ", decl)
+            name = declared_name(decl)
+            if (name == "")
+                return
+            for (i = 1; i <= count; i++)
+                if (introduceds[i] != "")
+                    print name "\t" platforms[i] "\t" introduceds[i] "\t" deprecateds[i]
+        }
+
+        BEGIN {
+            MACRO = "(CF|NS)_(ENUM_|CLASS_)?(AVAILABLE|DEPRECATED)(_IOS|_MAC|_IPHONE)?[ \t]*\\([^()]*\\)"
+            MACRO = MACRO "|__OSX_AVAILABLE_(STARTING|BUT_DEPRECATED)[ \t]*\\([^()]*\\)"
+            MACRO = MACRO "|__(IOS|OSX)_AVAILABLE[ \t]*\\([^()]*\\)"
+            MACRO = MACRO "|API_AVAILABLE[ \t]*\\(([^()]|\\([^()]*\\))*\\)"
+            MACRO = MACRO "|__AVAILABILITY_INTERNAL__(IPHONE|MAC)_[0-9_]+(_DEP__(IPHONE|MAC)_[0-9_]+)?"
+        }
+
+        FNR == 1 {
+            buffer = ""
+            in_comment = 0
+            in_directive = 0
+        }
+
+        {
+            line = $0
+            # Preprocessor directives, including their continuation lines, declare nothing.
+            if (in_directive || line ~ /^[ \t]*#/) {
+                in_directive = line ~ /\\$/
+                next
+            }
+            if (in_comment) {
+                if (!(i = index(line, "*/")))
+                    next
+                line = substr(line, i + 2)
+                in_comment = 0
+            }
+            gsub(/\/\*([^*]|\*+[^*\/])*\*+\//, " ", line)
+            sub(/\/\/.*/, "", line)
+            if (i = index(line, "/*")) {
+                line = substr(line, 1, i - 1)
+                in_comment = 1
+            }
+            if (line ~ /@(interface|protocol)/)
+                line = line ";"
+
+            buffer = buffer " " line
+            if (buffer !~ /AVAILAB|DEPRECATED/) {
+                if (match(buffer, /.*[;{}]/))
+                    buffer = substr(buffer, RSTART + RLENGTH)
+                next
+            }
+            # Jumps from one delimiter to the next rather than walking every character.
+            depth = 0
+            start = 1
+            i = 0
+            rest = buffer
+            while (match(rest, /[(){};,]/)) {
+                i += RSTART
+                c = substr(rest, RSTART, 1)
+                rest = substr(rest, RSTART + 1)
+                if (c == "(")
+                    depth++
+                else if (c == ")")
+                    depth--
+                else if (depth <= 0) {
+                    statement(substr(buffer, start, i - start))
+                    start = i + 1
+                    depth = 0
+                }
+            }
+            buffer = substr(buffer, start)
+        }' "$@"
+}
+
+# availability_index SDK JOBS
+#   Prints the availability index of SDK: a "#availability-index <fingerprint>" line, then one
+#   "<symbol>\t<PLATFORM>\t<introduced>\t<deprecated>\t<unavailable>" row per symbol and platform,
+#   sorted by symbol so lookups are a join or a binary search. Versions are the packed values of
+#   the version table (80000 for 8_0), 0 when not deprecated; a symbol declared several times
+#   keeps its earliest availability.
+availability_index() {
+    local SDK=$1
+    local JOBS=$2
+    local TABLE
+    local TAB
+    TAB=$(printf '\t')
+    TABLE=$(availability_table "$SDK")
+    echo "#availability-index $(availability_sdk_fingerprint "$SDK")"
+    availability_sdk_headers "$SDK" | \
+        xargs -0 -P "$JOBS" -n 256 bash -c '. "$0" && availability_extract "$@"' "${BASH_SOURCE[0]}" | \
+        awk -v table="$TABLE" '
+            BEGIN {
+                FS = OFS = "\t"
+                n = split(table, row, "\n")
+                for (i = 1; i <= n; i++) {
+                    split(row[i], field, " ")
+                    value[field[1], field[2]] = field[3]
+                }
+            }
+            $3 == "NA" {
+                print $1, $2, 0, 0
+                next
+            }
+            ($2, $3) in value {
+                print $1, $2, value[$2, $3], (($2, $4) in value ? value[$2, $4] : 0)
+            }' | \
+        LC_ALL=C sort -t "$TAB" -k1,1 -k2,2 -k3,3n -k4,4n | \
+        awk '
+            # Rows of a symbol and platform are adjacent, earliest first: no per-symbol map, and
+            # memory stays flat however large the SDK.
+            function flush() {
+                if (key != "")
+                    print symbol, platform, introduced, deprecated, introduced == 0
+            }
+            BEGIN { FS = OFS = "\t" }
+            $1 SUBSEP $2 != key {
+                flush()
+                key = $1 SUBSEP $2
+                symbol = $1
+                platform = $2
+                introduced = $3
+                deprecated = $4
+                next
+            }
+            introduced == 0 && $3 != 0 {
+                introduced = $3
+                deprecated = $4
+            }
+            END { flush() }'
+}
+
+# availability_sdk_fingerprint SDK
+#   Hash of the headers carrying availability information in SDK, including whether its
+#   CFAvailability.h is the hacked one.
+availability_sdk_fingerprint() {
+    local SDK=$1
+    availability_sdk_headers "$SDK" | LC_ALL=C sort -z | xargs -0 cat | shasum -a 256 | cut -c1-16
+}
+
+# availability_tokens [ios=SOFT_MAX mac=SOFT_MAX SOURCE]...
+#   Prints "<identifier>\t<source>\t<line>\t<column>\t<ios soft max>\t<mac soft max>" for every
+#   identifier of SOURCE outside comments and literals, except those between
+#   API_AVAILABILITY_START_IGNORE_TOO_NEW and API_AVAILABILITY_END_IGNORE_TOO_NEW, under
+#   #pragma clang diagnostic ignored "-Wdeprecated-declarations", inside @selector() or guarded.
+#   A guard is an if condition testing respondsToSelector:@selector(X) (or any @selector(X)),
+#   NSClassFromString(@"X"), [X class], &X, X != NULL, API_IS_AVAILABLE(X) or
+#   API_RESPONDS_TO_SELECTOR(object, X) (MJGAvailabilityProbe.h). It covers X in the condition and
+#   the body of the if, unless an || could make the condition true without it. Negated (!guard,
+#   &X == NULL, X == nil, !X) it covers the else branch, or the rest of the block when the body
+#   returns, unless an && could make the condition false without it.
+availability_tokens() {
+    awk '
+        function push() {
+            stack[++depth] = suppressed
+        }
+
+        function pop() {
+            if (depth > 0)
+                suppressed = stack[depth--]
+        }
+
+        function guarded(token,   i) {
+            for (i = 1; i <= frames; i++)
+                if (index(frame_names[i], " " token " "))
+                    return 1
+            return 0
+        }
+
+        function emit(token,   use) {
+            if (suppressed || guarded(token))
+                return
+            use = token "\t" FILENAME "\t" FNR "\t" column "\t" ios "\t" mac
+            if (condition)
+                pending[++npending] = token SUBSEP use
+            else
+                print use
+        }
+
+        # Prints the uses of the condition that its own guards do not cover.
+        function flush(names,   i, part) {
+            for (i = 1; i <= npending; i++) {
+                split(pending[i], part, SUBSEP)
+                if (!index(names, " " part[1] " "))
+                    print part[2]
+            }
+            npending = 0
+        }
+
+        # Records a guard of X; call is 1 when X is the argument of a call, such as
+        # API_IS_AVAILABLE(X), so that its level is that of the call.
+        function guard(token, call) {
+            guards++
+            guard_name[guards] = token
+            guard_level[guards] = parens - condition - call
+            guard_negated[guards] = negated
+        }
+
+        # kind is "block" (ends when braces drop below level) or "statement" (ends at the next ;
+        # at level).
+        function open_frame(kind, level, names, else_names) {
+            frames++
+            frame_kind[frames] = kind
+            frame_level[frames] = level
+            frame_names[frames] = names
+            frame_else[frames] = else_names
+            frame_returns[frames] = 0
+            frame_first[frames] = kind == "block"
+        }
+
+        function close_frame(   else_names, returns) {
+            else_names = frame_else[frames]
+            returns = frame_returns[frames]
+            frames--
+            if (else_names == "")
+                return
+            if (returns)
+                open_frame("block", braces, else_names, "")
+            else
+                awaiting_else = else_names
+        }
+
+        function use(token,   names, negated_names, i, level) {
+            if (awaiting_else != "") {
+                names = awaiting_else
+                awaiting_else = ""
+                if (token == "else") {
+                    body = names
+                    body_else = ""
+                    expect_body = 1
+                    return
+                }
+            }
+            if (expect_body) {
+                expect_body = 0
+                if (token == "{") {
+                    paren_stack[++braces] = parens
+                    parens = 0
+                    open_frame("block", braces, body, body_else)
+                    return
+                }
+                open_frame("statement", braces, body, body_else)
+                frame_returns[frames] = token == "return"
+            } else if (frames && frame_first[frames]) {
+                frame_first[frames] = 0
+                frame_returns[frames] = token == "return"
+            }
+            if (expect_condition) {
+                expect_condition = 0
+                if (token == "(") {
+                    parens++
+                    condition = parens
+                    guards = negated = calls = 0
+                    bang = compared = ""
+                    and_level = or_level = parens + 1000
+                    return
+                }
+            }
+
+            if (selector) {
+                if (token == ")")
+                    selector = 0
+                else if (condition && token ~ /^[A-Za-z_]/ && p1 == "(")
+                    guard(token, 1)
+                if (token != ")")
+                    return
+            }
+            # !X tests the address of a weakly imported X, unless X is called.
+            if (bang != "") {
+                if (token != "(")
+                    guard(bang, 0)
+                bang = ""
+            }
+            # &X == NULL negates the guard on X, and X == NULL is a negated guard.
+            if (compared != "") {
+                if (token ~ /^(NULL|nil|Nil|nullptr)$/) {
+                    level = parens - condition
+                    if (!(guards && guard_name[guards] == compared && guard_level[guards] == level))
+                        guard(compared, 0)
+                    guard_negated[guards] = !guard_negated[guards]
+                }
+                compared = ""
+            }
+
+            if (token == "(") {
+                parens++
+                if (p2 == "@" && p1 == "selector")
+                    selector = 1
+                # Parentheses of a call, whose arguments are not tested by the condition.
+                if (condition) {
+                    call_paren[parens] = p1 ~ /^[A-Za-z_]/ || p1 == ")" || p1 == "]"
+                    calls += call_paren[parens]
+                }
+            } else if (token == ")") {
+                if (condition && parens > condition)
+                    calls -= call_paren[parens]
+                if (condition && parens == condition) {
+                    # A guard holds in the body unless an || at its level or above could make
+                    # the condition true without it, and a negated guard holds in the else
+                    # branch unless an && could make the condition false without it.
+                    condition = 0
+                    names = negated_names = ""
+                    for (i = 1; i <= guards; i++) {
+                        if (!guard_negated[i] && guard_level[i] < or_level)
+                            names = names " " guard_name[i] " "
+                        else if (guard_negated[i] && guard_level[i] < and_level)
+                            negated_names = negated_names " " guard_name[i] " "
+                    }
+                    flush(names negated_names)
+                    if (names != "" || negated_names != "") {
+                        expect_body = 1
+                        body = names
+                        body_else = negated_names
+                    }
+                }
+                parens--
+            } else if (token == "{") {
+                paren_stack[++braces] = parens
+                parens = 0
+            } else if (token == "}") {
+                if (braces > 0)
+                    parens = paren_stack[braces--]
+                while (frames && braces < frame_level[frames])
+                    close_frame()
+            } else if (token == ";") {
+                while (frames && frame_kind[frames] == "statement" && braces == frame_level[frames] && parens == 0)
+                    close_frame()
+            } else if (token == "if") {
+                expect_condition = !condition
+            } else if (token == "!=") {
+                if (condition && p1 ~ /^[A-Za-z_]/)
+                    guard(p1, 0)
+            } else if (token == "==") {
+                if (condition && p1 ~ /^[A-Za-z_]/)
+                    compared = p1
+            } else if (token == "!") {
+                negated = condition > 0
+            } else if (token == "&&" || token == "||") {
+                if (condition) {
+                    level = parens - condition
+                    if (token == "&&" && level < and_level)
+                        and_level = level
+                    if (token == "||" && level < or_level)
+                        or_level = level
+                    negated = 0
+                }
+            } else if (token ~ /^[A-Za-z_]/) {
+                if (p3 == "NSClassFromString" && p2 == "(" && p1 == "@") {
+                    if (condition)
+                        guard(token, 1)
+                    return
+                }
+                # &X is an address test where an operand starts, outside any call: not in
+                # flags & X nor in memcmp(&X, ...).
+                if (condition && ((p1 == "&" && !calls && p2 ~ /^(\(|!|&&|\|\||==|!=)$/) || (token == "class" && p2 == "[")))
+                    guard(token == "class" ? p1 : token, 0)
+                else if (condition && p1 == "!")
+                    bang = token
+                if (condition && ((p2 == "API_IS_AVAILABLE" && p1 == "(") || (p3 == "API_RESPONDS_TO_SELECTOR" && p2 == "(")))
+                    guard(token, 1)
+                emit(token)
+            }
+        }
+
+        FNR == 1 {
+            flush("")
+            in_comment = 0
+            suppressed = 0
+            depth = 0
+            frames = braces = parens = 0
+            condition = expect_condition = expect_body = selector = 0
+            awaiting_else = bang = compared = p1 = p2 = p3 = ""
+        }
+
+        {
+            line = $0
+            # The body of a #define is scanned like code, its name and parameters blanked out.
+            if (match(line, /^[ \t]*#[ \t]*define[ \t]+[A-Za-z_][A-Za-z0-9_]*(\([^)]*\))?/)) {
+                line = sprintf("%" RLENGTH "s", "") substr(line, RLENGTH + 1)
+            } else if (line ~ /^[ \t]*#/) {
+                if (line ~ /^[ \t]*#[ \t]*pragma[ \t]+clang[ \t]+diagnostic[ \t]+push/)
+                    push()
+                else if (line ~ /^[ \t]*#[ \t]*pragma[ \t]+clang[ \t]+diagnostic[ \t]+pop/)
+                    pop()
+                else if (line ~ /^[ \t]*#[ \t]*pragma[ \t]+clang[ \t]+diagnostic[ \t]+ignored[ \t]+"-Wdeprecated-declarations"/)
+                    suppressed = 1
+                next
+            }
+
+            # Unquote the class name of NSClassFromString(@"X") so that it survives as a token.
+            out = ""
+            while (match(line, /NSClassFromString[ \t]*\([ \t]*@"[A-Za-z_][A-Za-z0-9_]*"/)) {
+                literal = substr(line, RSTART, RLENGTH)
+                i = index(literal, "@\"")
+                out = out substr(line, 1, RSTART - 1) substr(literal, 1, i) " " substr(literal, i + 2, RLENGTH - i - 2) " "
+                line = substr(line, RSTART + RLENGTH)
+            }
+            line = out line
+
+            # Blank out comments and literals, keeping columns.
+            out = ""
+            while (line != "") {
+                if (in_comment) {
+                    if (!(i = index(line, "*/"))) {
+                        out = out sprintf("%" length(line) "s", "")
+                        line = ""
+                        break
+                    }
+                    out = out sprintf("%" (i + 1) "s", "")
+                    line = substr(line, i + 2)
+                    in_comment = 0
+                }
+                if (!match(line, /\/\/|\/\*|"([^"\\]|\\.)*"|'\''([^'\''\\]|\\.)*'\''/))
+                    break
+                out = out substr(line, 1, RSTART - 1)
+                if (substr(line, RSTART, 2) == "//") {
+                    line = ""
+                    break
+                }
+                if (substr(line, RSTART, 2) == "/*") {
+                    out = out "  "
+                    line = substr(line, RSTART + 2)
+                    in_comment = 1
+                    continue
+                }
+                out = out sprintf("%" RLENGTH "s", "")
+                line = substr(line, RSTART + RLENGTH)
+            }
+            line = out line
+
+            column = 1
+            while (match(line, /[A-Za-z_][A-Za-z0-9_]*|!=|==|&&|\|\||[][(){};!&@]/)) {
+                token = substr(line, RSTART, RLENGTH)
+                column += RSTART - 1
+                line = substr(line, RSTART + RLENGTH)
+                if (token == "API_AVAILABILITY_START_IGNORE_TOO_NEW") {
+                    push()
+                    suppressed = 1
+                } else if (token == "API_AVAILABILITY_END_IGNORE_TOO_NEW") {
+                    pop()
+                } else {
+                    use(token)
+                }
+                p3 = p2
+                p2 = p1
+                p1 = token
+                column += length(token)
+            }
+        }
+
+        END { flush("") }' "$@"
+}
+
+# availability_floors TUS
+#   Prints "<ios floor> <mac floor>", the lowest soft max of each platform over the TUs of TUS
+#   (NUL-separated ios= / mac= / source triples), 0 for a platform none of them checks.
+availability_floors() {
+    tr '\0' '\n' < "$1" | awk '
+        function lowest(platform, values,   n, value, i) {
+            n = split(values, value, ",")
+            for (i = 1; i <= n; i++)
+                if (value[i] > 0 && (floor[platform] == 0 || value[i] < floor[platform]))
+                    floor[platform] = value[i]
+        }
+        NR % 3 == 1 { lowest("IPHONE", substr($0, 5)) }
+        NR % 3 == 2 { lowest("MAC", substr($0, 5)) }
+        END { print floor["IPHONE"] + 0, floor["MAC"] + 0 }'
+}
+
+# availability_candidates INDEX IOS_FLOOR MAC_FLOOR
+#   Prints the rows of INDEX that can be too new for a TU whose soft max is at least the floor
+#   of its platform (availability_floors): available, introduced after the floor. The soft max
+#   comparison runs once over the whole index instead of per lookup, and scans then join
+#   against the much smaller result.
+availability_candidates() {
+    awk -F '\t' -v ios="$2" -v mac="$3" '
+        FNR == 1 || ($5 == 0 && ($2 == "IPHONE" ? ios > 0 && $3 > ios : mac > 0 && $3 > mac))' "$1"
+}
+
+# availability_rules TABLE
+#   Prints a warning for every row of standard input, tokens of availability_tokens joined with
+#   index rows, whose symbol is introduced after a soft max of its platform.
+availability_rules() {
+    awk -F "$(printf '\t')" '
+        FILENAME == ARGV[1] {
+            split($0, field, " ")
+            name[field[1], field[3]] = field[2]
+            gsub(/_/, ".", name[field[1], field[3]])
+            next
+        }
+        {
+            if ($10)
+                next
+            label = $7 == "IPHONE" ? "iOS" : "OS X"
+            n = split($7 == "IPHONE" ? $5 : $6, soft_max, ",")
+            targets = ""
+            for (i = 1; i <= n && soft_max[i] > 0 && soft_max[i] < $8; i++)
+                targets = targets (i > 1 ? ", " : " for " label " ") name[$7, soft_max[i]]
+            if (i == 1)
+                next
+            if (n == 1)
+                targets = ""
+            printf "%s:%d:%d: warning: '\''%s'\'' is too new%s: API only available from %s %s, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage\n",
+                $2, $3, $4, $1, targets, label, name[$7, $8]
+        }' "$1" -
+}
+
+# availability_scan TABLE INDEX [ios=SOFT_MAXES mac=SOFT_MAXES SOURCE]...
+#   Prints a warning for every use in SOURCE of a symbol of INDEX (availability_index output)
+#   introduced after a soft max of its platform. SOFT_MAXES is an ascending comma-separated list,
+#   so a use is too new for a prefix of it and one scan covers every target; 0 disables the platform.
+#   The tokens are joined against the sorted index, which is never loaded in memory.
+availability_scan() {
+    local TABLE=$1
+    local INDEX=$2
+    local TAB
+    local START
+    local STAGE
+    TAB=$(printf '\t')
+    shift 2
+    if [ -z "$AVAILABILITY_EVENTS" ]; then
+        availability_tokens "$@" | LC_ALL=C sort -t "$TAB" -k1,1 | \
+            LC_ALL=C join -t "$TAB" - "$INDEX" | availability_rules "$TABLE"
+        return
+    fi
+    # Instrumented: the same pipeline one stage at a time, so that lexing and checking are timed
+    # apart.
+    STAGE=$(mktemp -d)
+    START=$(availability_now)
+    availability_tokens "$@" | LC_ALL=C sort -t "$TAB" -k1,1 > "${STAGE}/tokens"
+    availability_event lex scan "$START" $$ "tus=$(($# / 3)),tokens=$(wc -l < "${STAGE}/tokens")"
+    START=$(availability_now)
+    LC_ALL=C join -t "$TAB" "${STAGE}/tokens" "$INDEX" > "${STAGE}/matches"
+    availability_rules "$TABLE" < "${STAGE}/matches" > "${STAGE}/findings"
+    availability_event check scan "$START" $$ "matches=$(wc -l < "${STAGE}/matches"),findings=$(wc -l < "${STAGE}/findings")"
+    availability_metric tus_scanned $(($# / 3))
+    availability_metric symbols_looked_up "$(wc -l < "${STAGE}/tokens")"
+    availability_metric index_matches "$(wc -l < "${STAGE}/matches")"
+    cat "${STAGE}/findings"
+    rm -rf "$STAGE"
+}
+
+# availability_now
+#   Microseconds since the epoch.
+availability_now() {
+    if [ -n "$EPOCHREALTIME" ]; then
+        echo "${EPOCHREALTIME/[.,]/}"
+    else
+        perl -MTime::HiRes=time -e 'printf "%d\n", time * 1000000'
+    fi
+}
+
+# availability_event NAME CATEGORY START TID [ARGS]
+#   Records a span from START (availability_now) to now in AVAILABILITY_EVENTS, when set, as an
+#   "X\t<name>\t<category>\t<start>\t<duration>\t<tid>\t<args>" line. ARGS is a comma-separated
+#   list of key=number. Lines are appended in one write, so parallel workers can share the file.
+availability_event() {
+    local END
+    if [ -n "$AVAILABILITY_EVENTS" ]; then
+        END=$(availability_now)
+        printf 'X\t%s\t%s\t%s\t%s\t%s\t%s\n' "$1" "$2" "$3" $((END - $3)) "$4" "$5" >> "$AVAILABILITY_EVENTS"
+    fi
+}
+
+# availability_sample NAME VALUE
+#   Records the current VALUE of the gauge NAME, e.g. a queue depth, as a "C" line.
+availability_sample() {
+    if [ -n "$AVAILABILITY_EVENTS" ]; then
+        printf 'C\t%s\t\t%s\t0\t0\t%s\n' "$1" "$(availability_now)" "$2" >> "$AVAILABILITY_EVENTS"
+    fi
+}
+
+# availability_metric NAME VALUE
+#   Adds VALUE to the counter NAME, as an "M" line.
+availability_metric() {
+    if [ -n "$AVAILABILITY_EVENTS" ]; then
+        printf 'M\t%s\t\t0\t0\t0\t%s\n' "$1" "$2" >> "$AVAILABILITY_EVENTS"
+    fi
+}
+
+# availability_trace_events EVENTS
+#   Prints EVENTS as Chrome trace events, for chrome://tracing, Perfetto or speedscope. The depth
+#   of the local batch queue is derived from the start of each lex span.
+availability_trace_events() {
+    LC_ALL=C sort -t "$(printf '\t')" -k4,4n "$1" | awk -F '\t' '
+        function arguments(list,   n, pair, i, out) {
+            n = split(list, pair, ",")
+            out = ""
+            for (i = 1; i <= n; i++) {
+                sub(/=/, "\": ", pair[i])
+                out = out (i > 1 ? ", " : "") "\"" pair[i]
+            }
+            return "{" out "}"
+        }
+        function emit(event) {
+            printf "%s\n  %s", (events++ ? "," : ""), event
+        }
+        $1 == "M" { next }
+        !origin { origin = $4 }
+        $1 == "X" && $2 == "lex" { lexes++ }
+        { line[++n] = $0 }
+        END {
+            printf "{\"traceEvents\": ["
+            for (i = 1; i <= n; i++) {
+                split(line[i], f, "\t")
+                if (f[1] == "X") {
+                    emit(sprintf("{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %d, \"dur\": %d, \"pid\": 1, \"tid\": %d, \"args\": %s}",
+                        f[2], f[3], f[4] - origin, f[5], f[6], arguments(f[7])))
+                    if (f[2] == "lex")
+                        emit(sprintf("{\"name\": \"queued batches\", \"ph\": \"C\", \"ts\": %d, \"pid\": 1, \"args\": {\"batches\": %d}}",
+                            f[4] - origin, --lexes))
+                } else
+                    emit(sprintf("{\"name\": \"%s\", \"ph\": \"C\", \"ts\": %d, \"pid\": 1, \"args\": {\"value\": %s}}",
+                        f[2], f[4] - origin, f[7]))
+            }
+            printf "\n]}\n"
+        }'
+}
+
+# availability_prometheus EVENTS
+#   Prints EVENTS as Prometheus text exposition, e.g. for the node_exporter textfile collector:
+#   phase durations, histograms of batch and shard latency, counters and queue depth peaks.
+availability_prometheus() {
+    awk -F '\t' '
+        BEGIN {
+            buckets = split("0.005 0.01 0.025 0.05 0.1 0.25 0.5 1 2.5 5 10", le, " ")
+        }
+        function observe(key, seconds,   i) {
+            for (i = 1; i <= buckets; i++)
+                if (seconds <= le[i])
+                    bucket[key, i]++
+            count[key]++
+            sum[key] += seconds
+            keys[key]
+        }
+        $1 == "M" { counter[$2] += $7 }
+        $1 == "C" && $7 > peak[$2] { peak[$2] = $7 }
+        $1 == "C" { peaks[$2] }
+        $1 == "X" && $3 == "phase" { phase[$2] += $5 / 1e6 }
+        $1 == "X" && $3 == "scan" { observe("availability_batch_seconds{phase=\"" $2 "\"", $5 / 1e6) }
+        $1 == "X" && $3 == "shard" { observe("availability_shard_seconds{worker=\"" $2 "\"", $5 / 1e6) }
+        $1 == "X" && $2 == "lex" { lexes++ }
+        END {
+            print "# HELP availability_phase_seconds Wall time of each phase of the last check."
+            print "# TYPE availability_phase_seconds gauge"
+            for (p in phase)
+                printf "availability_phase_seconds{phase=\"%s\"} %.6f\n", p, phase[p]
+            if (phase["scan"] + phase["workers"] > 0) {
+                print "# HELP availability_tus_per_second TUs scanned per second of the scan and workers phases."
+                print "# TYPE availability_tus_per_second gauge"
+                printf "availability_tus_per_second %.1f\n", counter["tus_scanned"] / (phase["scan"] + phase["workers"])
+            }
+            for (c in counter) {
+                printf "# TYPE availability_%s_total counter\n", c
+                printf "availability_%s_total %d\n", c, counter[c]
+            }
+            if (lexes) {
+                peak["queued_batches"] = lexes
+                peaks["queued_batches"]
+            }
+            for (q in peaks) {
+                printf "# TYPE availability_%s_max gauge\n", q
+                printf "availability_%s_max %d\n", q, peak[q]
+            }
+            # All the samples of a histogram must follow its TYPE line.
+            for (key in keys) {
+                metric = key
+                sub(/\{.*/, "", metric)
+                family[key] = metric
+                families[metric]
+            }
+            for (metric in families) {
+                printf "# TYPE %s histogram\n", metric
+                for (key in keys) {
+                    if (family[key] != metric)
+                        continue
+                    labels = substr(key, length(metric) + 1)
+                    for (i = 1; i <= buckets; i++)
+                        printf "%s_bucket%s,le=\"%s\"} %d\n", metric, labels, le[i], bucket[key, i]
+                    printf "%s_bucket%s,le=\"+Inf\"} %d\n", metric, labels, count[key]
+                    printf "%s_sum%s} %.6f\n", metric, labels, sum[key]
+                    printf "%s_count%s} %d\n", metric, labels, count[key]
+                }
+            }
+        }' "$1"
+}
+
+# availability_include_graph GRAPH WORK
+#   Prints "<path>\t" for every C family source and header tracked by the git repository of the
+#   current directory, then "<path>\t<included name>" for each of its #include / #import, paths
+#   relative to the top level. GRAPH caches the includes of each content by blob hash, so only new or modified
+#   contents are read; it is rewritten to hold the current tree only.
+availability_include_graph() {
+    local GRAPH=$1
+    local WORK=$2
+    local TOP
+    TOP=$(git rev-parse --show-toplevel)
+    git -C "$TOP" ls-files -s -z | tr '\0' '\n' | \
+        awk -F '\t' '$2 ~ /\.(h|hh|hpp|hxx|inc|def|c|cc|cpp|cxx|m|mm)$/ { split($1, field, " ") ; print field[2] "\t" $2 }' \
+        > "${WORK}/blobs"
+    # Contents modified in the working tree but not staged aren't in the index yet.
+    git -C "$TOP" diff --name-only -z | tr '\0' '\n' | \
+        awk -F '\t' 'FILENAME == ARGV[1] { tracked[$2] ; next } $0 in tracked' "${WORK}/blobs" - \
+        > "${WORK}/modified"
+    if [ -s "${WORK}/modified" ]; then
+        (cd "$TOP" && git hash-object --stdin-paths < "${WORK}/modified") | \
+            paste - "${WORK}/modified" | \
+            awk -F '\t' 'FILENAME == ARGV[1] { blob[$2] = $1 ; next } { print ($2 in blob ? blob[$2] : $1) "\t" $2 }' \
+                - "${WORK}/blobs" > "${WORK}/blobs.modified"
+        mv "${WORK}/blobs.modified" "${WORK}/blobs"
+    fi
+    touch "$GRAPH"
+    # Known contents keep their cached rows ("<blob>\t" alone for a content without includes),
+    # the others are read again.
+    awk -F '\t' -v work="$WORK" '
+        FILENAME == ARGV[1] {
+            cached[$1] = cached[$1] $0 "\n"
+            next
+        }
+        $1 in cached {
+            printf "%s", cached[$1] > (work "/graph")
+            delete cached[$1]
+            next
+        }
+        !($1 in parsing) {
+            parsing[$1]
+            print $1 "\t" > (work "/graph")
+            print $0 > (work "/parse")
+        }
+        END {
+            printf "" > (work "/graph")
+            printf "" > (work "/parse")
+        }' "$GRAPH" "${WORK}/blobs"
+    if [ -s "${WORK}/parse" ]; then
+        cut -f2 "${WORK}/parse" | (cd "$TOP" && tr '\n' '\0' | xargs -0 awk '
+            FNR == 1 { path = FILENAME }
+            /^[ \t]*#[ \t]*(include|import)[ \t]*["<]/ {
+                name = $0
+                sub(/^[ \t]*#[ \t]*(include|import)[ \t]*["<]/, "", name)
+                sub(/[">].*/, "", name)
+                print path "\t" name
+            }') | \
+            awk -F '\t' 'FILENAME == ARGV[1] { blob[$2] = $1 ; next } { print blob[$1] "\t" $2 }' \
+                "${WORK}/parse" - >> "${WORK}/graph"
+    fi
+    mv "${WORK}/graph" "${GRAPH}.tmp.$$"
+    mv -f "${GRAPH}.tmp.$$" "$GRAPH"
+    awk -F '\t' '
+        FILENAME == ARGV[1] {
+            if ($2 != "")
+                names[$1] = names[$1] $2 "\n"
+            next
+        }
+        {
+            print $2 "\t"
+            n = split(names[$1], name, "\n")
+            for (i = 1; i < n; i++)
+                print $2 "\t" name[i]
+        }' "$GRAPH" "${WORK}/blobs"
+}
+
+# availability_affected_files RANGE GRAPH WORK
+#   Prints the absolute paths of the files changed by RANGE, anything git diff takes (HEAD for
+#   the working tree against the last commit, origin/main...HEAD for a branch), and of the
+#   sources and headers including them, directly or not. GRAPH is the include graph cache of
+#   availability_include_graph. Included names resolve by path suffix, else by file name like
+#   Xcode's header maps: an ambiguous name fans out to every candidate, which checks more TUs
+#   than needed but never misses one.
+availability_affected_files() {
+    local RANGE=$1
+    local GRAPH=$2
+    local WORK=$3
+    local TOP
+    TOP=$(git rev-parse --show-toplevel)
+    git -C "$TOP" diff --name-only --no-renames -z "$RANGE" -- | tr '\0' '\n' > "${WORK}/changed"
+    availability_include_graph "$GRAPH" "$WORK" > "${WORK}/includes"
+    awk -F '\t' -v top="$TOP" '
+        function file_name(path) {
+            sub(/.*\//, "", path)
+            return path
+        }
+
+        FILENAME == ARGV[1] {
+            changed[++changes] = $0
+            known[$0]
+            next
+        }
+
+        # Every tracked source, and the changed files, even deleted ones.
+        $2 == "" {
+            known[$1]
+            next
+        }
+
+        {
+            edges++
+            from[edges] = $1
+            to[edges] = $2
+        }
+
+        END {
+            for (path in known)
+                candidates[file_name(path)] = candidates[file_name(path)] path "\n"
+            # Reverse edges: included path -> "\n"-separated includers.
+            for (e = 1; e <= edges; e++) {
+                name = to[e]
+                while (sub(/^\.\.?\//, "", name))
+                    ;
+                n = split(candidates[file_name(name)], candidate, "\n")
+                matched = ""
+                if (name ~ /\//)
+                    for (i = 1; i < n; i++)
+                        if (candidate[i] == name || substr(candidate[i], length(candidate[i]) - length(name)) == "/" name)
+                            matched = matched candidate[i] "\n"
+                if (matched == "")
+                    for (i = 1; i < n; i++)
+                        matched = matched candidate[i] "\n"
+                n = split(matched, candidate, "\n")
+                for (i = 1; i < n; i++)
+                    includers[candidate[i]] = includers[candidate[i]] from[e] "\n"
+            }
+            for (i = 1; i <= changes; i++)
+                affected[changed[i]]
+            while (changes > 0) {
+                path = changed[changes--]
+                n = split(includers[path], includer, "\n")
+                for (i = 1; i < n; i++)
+                    if (!(includer[i] in affected)) {
+                        affected[includer[i]]
+                        changed[++changes] = includer[i]
+                    }
+            }
+            for (path in affected)
+                print top "/" path
+        }' "${WORK}/changed" "${WORK}/includes"
+}
+
+# availability_project_headers TUS INCLUDES [SEARCH]
+#   Prints the TU list of the project headers included by the TUs of TUS, directly or not, each
+#   with the soft max values of the TUs including it, once per header and soft max values.
+#   INCLUDES is the output of availability_include_graph, SEARCH has a "<source>\t<dir>..." line
+#   per TU with its -iquote and -I directories, absolute. An included name resolves against the
+#   directory of its includer, then those of the TU including it. Only a name resolving nowhere
+#   falls back to path suffix, else (without a directory) file name like Xcode's header maps.
+#   Names found nowhere in the repository, such as SDK headers, are skipped.
+availability_project_headers() {
+    local TUS=$1
+    local INCLUDES=$2
+    local SEARCH=${3:-/dev/null}
+    local TOP
+    TOP=$(git rev-parse --show-toplevel)
+    tr '\0' '\n' < "$TUS" | awk -F '\t' -v top="$TOP" '
+        function file_name(path) {
+            sub(/.*\//, "", path)
+            return path
+        }
+
+        function normalize(path,   n, part, k, i, out) {
+            n = split(path, part, "/")
+            k = 0
+            for (i = 1; i <= n; i++) {
+                if (part[i] == "" || part[i] == ".")
+                    continue
+                if (part[i] == ".." && k > 0 && kept[k] != "..")
+                    k--
+                else
+                    kept[++k] = part[i]
+            }
+            out = kept[1]
+            for (i = 2; i <= k; i++)
+                out = out "/" kept[i]
+            return out
+        }
+
+        # The "\n"-separated paths NAME, included by FROM with the search directories DIRS,
+        # resolves to.
+        function resolve(from, name, dirs,   key, directory, path, n, candidate, i, matched, dir) {
+            key = from "\t" name "\t" dirs
+            if (key in resolved)
+                return resolved[key]
+            directory = from
+            if (!sub(/\/[^\/]*$/, "", directory))
+                directory = ""
+            path = normalize(directory "/" name)
+            matched = ""
+            if (path in known)
+                matched = path "\n"
+            n = split(dirs, dir, "\n")
+            for (i = 1; i < n && matched == ""; i++) {
+                path = normalize(dir[i] "/" name)
+                if (path in known)
+                    matched = path "\n"
+            }
+            if (matched == "") {
+                while (sub(/^\.\.?\//, "", name))
+                    ;
+                n = split(candidates[file_name(name)], candidate, "\n")
+                for (i = 1; i < n; i++)
+                    if (name !~ /\// || candidate[i] == name || \
+                        substr(candidate[i], length(candidate[i]) - length(name)) == "/" name)
+                        matched = matched candidate[i] "\n"
+            }
+            resolved[key] = matched
+            return matched
+        }
+
+        FILENAME == ARGV[1] {
+            if ($2 == "") {
+                known[$1]
+                candidates[file_name($1)] = candidates[file_name($1)] $1 "\n"
+            } else {
+                names[$1] = names[$1] $2 "\n"
+            }
+            next
+        }
+
+        # Directories inside the repository, relative to it like INCLUDES, in search order.
+        FILENAME == ARGV[2] {
+            if (index($1, top "/") != 1)
+                next
+            source = substr($1, length(top) + 2)
+            root = normalize(top)
+            for (i = 2; i <= NF; i++) {
+                path = normalize($i)
+                if (path == root)
+                    path = ""
+                else if (index(path, root "/") == 1)
+                    path = substr(path, length(root) + 2)
+                else
+                    continue
+                if (!((source, path) in searched)) {
+                    searched[source, path]
+                    search[source] = search[source] path "\n"
+                }
+            }
+            next
+        }
+
+        FNR % 3 == 1 {
+            ios = $0
+            next
+        }
+
+        FNR % 3 == 2 {
+            mac = $0
+            next
+        }
+
+        index($0, top "/") == 1 {
+            tus++
+            tu[tus] = substr($0, length(top) + 2)
+            tu_ios[tus] = ios
+            tu_mac[tus] = mac
+            visited[tu[tus], ios, mac]
+        }
+
+        # A header visited for some soft max values had its own includes visited for them too.
+        END {
+            for (t = 1; t <= tus; t++) {
+                queue[queued = 1] = tu[t]
+                while (queued > 0) {
+                    path = queue[queued--]
+                    n = split(names[path], included, "\n")
+                    for (i = 1; i < n; i++) {
+                        m = split(resolve(path, included[i], search[tu[t]]), header, "\n")
+                        for (j = 1; j < m; j++) {
+                            if ((header[j], tu_ios[t], tu_mac[t]) in visited)
+                                continue
+                            visited[header[j], tu_ios[t], tu_mac[t]]
+                            queue[++queued] = header[j]
+                            printf "%s%c%s%c%s/%s%c", tu_ios[t], 0, tu_mac[t], 0, top, header[j], 0
+                        }
+                    }
+                }
+            }
+        }' "$INCLUDES" "$SEARCH" -
+}
+
+# availability_socket_address CONNECT|LISTEN SOCKET
+#   The socat address of SOCKET: a Unix domain socket path, or already a socat address such as
+#   TCP:host:7000 when it contains a colon.
+availability_socket_address() {
+    case $2 in
+        *:*) echo "$2" ;;
+        *) echo "UNIX-$1:$2" ;;
+    esac
+}
+
+# availability_shard TUS SHARDS WORK
+#   Splits TUS (NUL-separated ios= / mac= / source triples) into at most SHARDS files of
+#   WORK/queue of about the same estimated cost, the size of the sources: largest TU first,
+#   each to the lightest shard so far.
+availability_shard() {
+    local TUS=$1
+    local SHARDS=$2
+    local WORK=$3
+    mkdir -p "${WORK}/queue"
+    tr '\0' '\n' < "$TUS" | awk 'NR % 3 == 0' | tr '\n' '\0' | xargs -0 wc -c > "${WORK}/sizes"
+    tr '\0' '\n' < "$TUS" | awk '
+        FILENAME == ARGV[1] {
+            size = $1
+            sub(/^ *[0-9]+ /, "")
+            cost[$0] = size
+            next
+        }
+        FNR % 3 == 1 { ios = $0 ; next }
+        FNR % 3 == 2 { mac = $0 ; next }
+        { printf "%d\t%s\t%s\t%s\n", cost[$0], ios, mac, $0 }' "${WORK}/sizes" - | \
+        sort -t "$(printf '\t')" -k1,1nr | \
+        awk -F '\t' -v shards="$SHARDS" -v queue="${WORK}/queue" '
+            {
+                lightest = 1
+                for (i = 2; i <= shards; i++)
+                    if (load[i] < load[lightest])
+                        lightest = i
+                load[lightest] += $1 + 1
+                printf "%s%c%s%c%s%c", $2, 0, $3, 0, $4, 0 > sprintf("%s/%04d", queue, lightest)
+            }'
+}
+
+# availability_dispatch WORKER ID FLOORS WORK
+#   Sends the shards of WORK/queue one at a time to WORKER, an availabilityDaemon.sh socket, until
+#   none is left. FLOORS ends with the fingerprint of the coordinator's index; a worker whose index
+#   has another one refuses the shard and is given up at once. A shard being run moves to WORK/running/<shard>.<ID>; its findings are linked
+#   as WORK/done/<shard> by the first worker to finish it. A failed shard goes back to the queue,
+#   or to WORK/failed after MAX_ATTEMPTS; a worker failing twice in a row is given up. With the
+#   queue empty, an idle worker steals a shard another one is still running, once per shard, so
+#   a slow worker doesn't hold up the end of the run.
+availability_dispatch() {
+    local WORKER=$1
+    local ID=$2
+    local FLOORS=$3
+    local WORK=$4
+    local MAX_ATTEMPTS=3
+    # Seconds without any byte from a worker before its shard is given up.
+    local TIMEOUT=300
+    local FAILURES=0
+    local ADDRESS
+    local SHARD
+    local RUNNING
+    local NAME
+    local START
+    ADDRESS=$(availability_socket_address CONNECT "$WORKER")
+    while true ; do
+        RUNNING=""
+        for SHARD in "${WORK}"/queue/* ; do
+            NAME=$(basename "$SHARD")
+            if mv "$SHARD" "${WORK}/running/${NAME}.${ID}" 2> /dev/null ; then
+                RUNNING="${WORK}/running/${NAME}.${ID}"
+                break
+            fi
+        done
+        if [ -z "$RUNNING" ]; then
+            for SHARD in "${WORK}"/running/* ; do
+                NAME=$(basename "$SHARD")
+                NAME=${NAME%.*}
+                if [ -f "$SHARD" ] && [ ! -e "${WORK}/done/${NAME}" ] && mkdir "${WORK}/stolen/${NAME}" 2> /dev/null ; then
+                    cp "$SHARD" "${WORK}/stolen/${NAME}/shard" 2> /dev/null || continue
+                    echo "steal ${NAME} ${WORKER}" >> "${WORK}/log"
+                    RUNNING="${WORK}/stolen/${NAME}/shard"
+                    break
+                fi
+            done
+        fi
+        if [ -z "$RUNNING" ]; then
+            # Nothing to take: wait while another worker may still give a shard back.
+            for SHARD in "${WORK}"/running/* ; do
+                NAME=$(basename "$SHARD")
+                if [ -f "$SHARD" ] && [ ! -e "${WORK}/done/${NAME%.*}" ]; then
+                    RUNNING=$SHARD
+                fi
+            done
+            if [ -z "$RUNNING" ]; then
+                return 0
+            fi
+            sleep 0.1
+            continue
+        fi
+        START=$(availability_now)
+        { echo "@shard ${FLOORS}" ; cat "$RUNNING" ; } | \
+            socat -t 30 -T "$TIMEOUT" - "$ADDRESS" > "${WORK}/result.${ID}" 2> /dev/null || true
+        if [ "$(head -1 "${WORK}/result.${ID}" | cut -d' ' -f1)" = "@mismatch" ]; then
+            echo "Worker ${WORKER} has index $(head -1 "${WORK}/result.${ID}" | cut -d' ' -f2), not $(echo "$FLOORS" | cut -d' ' -f3), giving it up" >&2
+            [ "$RUNNING" = "${WORK}/running/${NAME}.${ID}" ] && mv "$RUNNING" "${WORK}/queue/${NAME}"
+            return 0
+        fi
+        if [ "$(tail -1 "${WORK}/result.${ID}")" = "@done" ]; then
+            availability_event "$WORKER" shard "$START" "$ID" "tus=$(($(tr -cd '\0' < "$RUNNING" | wc -c) / 3))"
+            availability_metric tus_scanned $(($(tr -cd '\0' < "$RUNNING" | wc -c) / 3))
+            FAILURES=0
+            sed '$d' "${WORK}/result.${ID}" > "${WORK}/result.${ID}.${NAME}"
+            ln "${WORK}/result.${ID}.${NAME}" "${WORK}/done/${NAME}" 2> /dev/null || true
+            rm -f "${WORK}/result.${ID}.${NAME}"
+            [ "$RUNNING" = "${WORK}/running/${NAME}.${ID}" ] && rm -f "$RUNNING"
+            continue
+        fi
+        FAILURES=$((FAILURES + 1))
+        echo "fail ${NAME} ${WORKER}" >> "${WORK}/log"
+        if [ "$RUNNING" = "${WORK}/running/${NAME}.${ID}" ]; then
+            if [ "$(grep -c "^fail ${NAME} " "${WORK}/log")" -ge $MAX_ATTEMPTS ]; then
+                mv "$RUNNING" "${WORK}/failed/${NAME}"
+            else
+                mv "$RUNNING" "${WORK}/queue/${NAME}"
+            fi
+        fi
+        if [ $FAILURES -ge 2 ]; then
+            echo "Worker ${WORKER} failed twice in a row, giving it up" >&2
+            return 0
+        fi
+    done
+}
+
+# availability_distribute WORKERS TUS WORK INDEX
+#   Scans TUS (NUL-separated ios= / mac= / source triples) on WORKERS, comma-separated
+#   availabilityDaemon.sh sockets, through one availability_dispatch per worker; only workers
+#   whose index has the fingerprint of INDEX are used. Prints the findings of each shard once. The triples no worker could scan are left in WORK/leftover, to
+#   be scanned locally.
+availability_distribute() {
+    local WORKERS=$1
+    local TUS=$2
+    local WORK=$3
+    local INDEX=$4
+    local WORKER
+    local COUNT=0
+    local SHARDS
+    local SHARD
+    local NAME
+    local PIDS=""
+    local FLOORS
+    FLOORS="$(availability_floors "$TUS") $(head -1 "$INDEX" | cut -d' ' -f2)"
+    mkdir -p "${WORK}/queue" "${WORK}/running" "${WORK}/done" "${WORK}/failed" "${WORK}/stolen"
+    : > "${WORK}/log"
+    for WORKER in ${WORKERS//,/ } ; do
+        COUNT=$((COUNT + 1))
+    done
+    # A few shards per worker, so that faster workers take more of them.
+    availability_shard "$TUS" $((4 * COUNT)) "$WORK"
+    SHARDS=$(ls "${WORK}/queue" | wc -l)
+    COUNT=0
+    # Each dispatcher gets its own process group, so that stopping it also stops its socat.
+    set -m
+    for WORKER in ${WORKERS//,/ } ; do
+        COUNT=$((COUNT + 1))
+        availability_dispatch "$WORKER" "$COUNT" "$FLOORS" "$WORK" &
+        PIDS="$PIDS -$!"
+    done
+    set +m
+    # Stragglers whose shards were finished by a thief aren't waited for.
+    while [ $(($(ls "${WORK}/done" | wc -l) + $(ls "${WORK}/failed" | wc -l))) -lt "$SHARDS" ] && \
+        kill -0 -- $PIDS 2> /dev/null ; do
+        availability_sample queued_shards "$(ls "${WORK}/queue" | wc -l)"
+        availability_sample running_shards "$(ls "${WORK}/running" | wc -l)"
+        sleep 0.1
+    done
+    kill -- $PIDS 2> /dev/null || true
+    wait 2> /dev/null || true
+    find "${WORK}/done" -type f -exec cat {} +
+    : > "${WORK}/leftover"
+    for SHARD in "${WORK}"/queue/* "${WORK}"/running/* "${WORK}"/failed/* ; do
+        NAME=$(basename "$SHARD")
+        if [ -f "$SHARD" ] && [ ! -e "${WORK}/done/${NAME%.*}" ]; then
+            cat "$SHARD" >> "${WORK}/leftover"
+        fi
+    done
+    awk -v shards="$SHARDS" -v workers="$COUNT" -v leftover="$(tr -cd '\0' < "${WORK}/leftover" | wc -c)" '
+        $1 == "steal" { stolen++ }
+        $1 == "fail" { failed++ }
+        END {
+            printf "workers: %d shards on %d workers, %d stolen, %d failed attempts, %d TUs left to scan locally\n",
+                shards, workers, stolen, failed, leftover / 3 > "/dev/stderr"
+        }' "${WORK}/log"
+}
+
+# availability_cache_salt INDEX
+#   Part of every cache key that doesn't depend on the TU: the SDK fingerprint recorded in
+#   INDEX and the checker itself.
+availability_cache_salt() {
+    { head -1 "$1" ; cat "${BASH_SOURCE[0]}" ; } | shasum -a 256 | cut -c1-16
+}
+
+# availability_cache_lookup CACHE SALT TUS WORK
+#   Splits TUS (NUL-separated ios= / mac= / source triples) between cached and uncached ones.
+#   Findings of cache hits go to WORK/cached, the remaining triples to WORK/misses and their
+#   "<key>\t<source>" to WORK/keys. Entries are named after the source content hash, the soft
+#   max values and SALT, so CI agents sharing CACHE reuse each other's results.
+availability_cache_lookup() {
+    local CACHE=$1
+    local SALT=$2
+    local TUS=$3
+    local WORK=$4
+    mkdir -p "$CACHE"
+    tr '\0' '\n' < "$TUS" | awk 'NR % 3 == 0' | tr '\n' '\0' | xargs -0 shasum -a 256 > "${WORK}/hashes"
+    tr '\0' '\n' < "$TUS" | awk -v cache="$CACHE" -v salt="$SALT" -v work="$WORK" '
+        FILENAME == ARGV[1] {
+            hash[substr($0, 67)] = substr($0, 1, 64)
+            next
+        }
+        FNR % 3 == 1 {
+            ios = $0
+            next
+        }
+        FNR % 3 == 2 {
+            mac = $0
+            next
+        }
+        {
+            key = hash[$0] "-" substr(ios, 5) "-" substr(mac, 5) "-" salt
+            entry = cache "/" key
+            if ((found = (getline line < entry)) >= 0) {
+                hits++
+                while (found > 0) {
+                    print $0 ":" line > (work "/cached")
+                    found = getline line < entry
+                }
+                close(entry)
+                print entry > (work "/hits")
+            } else {
+                misses++
+                printf "%s%c%s%c%s%c", ios, 0, mac, 0, $0, 0 > (work "/misses")
+                print key "\t" $0 > (work "/keys")
+            }
+        }
+        END {
+            printf "" > (work "/cached")
+            printf "" > (work "/hits")
+            printf "" > (work "/misses")
+            printf "" > (work "/keys")
+            total = hits + misses
+            printf "cache: %d hits, %d misses (%d%% hit rate)\n", hits, misses, total ? hits * 100 / total : 0 > "/dev/stderr"
+            if (ENVIRON["AVAILABILITY_EVENTS"] != "")
+                printf "M\tcache_hits\t\t0\t0\t0\t%d\nM\tcache_misses\t\t0\t0\t0\t%d\n", hits, misses >> ENVIRON["AVAILABILITY_EVENTS"]
+        }' "${WORK}/hashes" -
+    if [ -s "${WORK}/hits" ]; then
+        xargs touch -c < "${WORK}/hits"
+    fi
+}
+
+# availability_cache_store CACHE WORK FINDINGS MAX_ENTRIES
+#   Records FINDINGS of the sources listed in WORK/keys under their keys, including an empty
+#   entry for clean sources, then evicts the least recently used entries beyond MAX_ENTRIES.
+#   A source scanned under several soft max values (shared by iOS and OS X TUs, or a header
+#   included by TUs with different soft max values) has one key each: its findings are turned
+#   back into index rows and checked again with the soft max values of every key, against
+#   WORK/table, so that each entry holds what a scan with that key alone reports.
+availability_cache_store() {
+    local CACHE=$1
+    local WORK=$2
+    local FINDINGS=$3
+    local MAX_ENTRIES=$4
+    local STAGING
+    CACHE=$(cd "$CACHE" && pwd) || return 1
+    STAGING="${CACHE}/.staging.$$"
+    mkdir -p "$STAGING" || return 1
+    awk -F '\t' -v staging="$STAGING" -v rows="${WORK}/rows" '
+        FILENAME == ARGV[1] {
+            keys[$2]++
+            key[$2, keys[$2]] = $1
+            printf "" > (staging "/" $1)
+            close(staging "/" $1)
+            next
+        }
+        FILENAME == ARGV[2] {
+            split($0, field, " ")
+            version = field[2]
+            gsub(/_/, ".", version)
+            packed[field[1] == "IPHONE" ? "iOS" : "OS X", version] = field[3]
+            next
+        }
+        match($0, /:[0-9]+:[0-9]+: /) {
+            file = substr($0, 1, RSTART - 1)
+            if (!(file in keys))
+                next
+            if (keys[file] == 1) {
+                entry = staging "/" key[file, 1]
+                print substr($0, RSTART + 1) >> entry
+                close(entry)
+                next
+            }
+            split(substr($0, RSTART + 1), position, ":")
+            split($0, quoted, "\047")
+            match($0, /available from (iOS|OS X) [0-9.]+/)
+            introduced = substr($0, RSTART + 15, RLENGTH - 15)
+            label = introduced ~ /^iOS/ ? "iOS" : "OS X"
+            sub(/^(iOS|OS X) /, "", introduced)
+            # The rows of availability_tokens joined with the index, with the key as the source.
+            for (i = 1; i <= keys[file]; i++) {
+                split(key[file, i], part, "-")
+                printf "%s\t%s\t%d\t%d\t%s\t%s\t%s\t%d\t0\t0\n", quoted[2], key[file, i],
+                    position[1], position[2], part[2], part[3], (label == "iOS" ? "IPHONE" : "MAC"),
+                    packed[label, introduced] > rows
+            }
+        }
+        END {
+            printf "" > rows
+        }' "${WORK}/keys" "${WORK}/table" "$FINDINGS"
+    availability_rules "${WORK}/table" < "${WORK}/rows" | LC_ALL=C sort -u | awk -v staging="$STAGING" '
+        {
+            entry = staging "/" substr($0, 1, index($0, ":") - 1)
+            print substr($0, index($0, ":") + 1) >> entry
+            close(entry)
+        }'
+    # Renames within CACHE, so readers never see a partially written entry.
+    (cd "$STAGING" && ls | xargs sh -c '[ $# -eq 0 ] || mv -f "$@" "$0"' "$CACHE") || {
+        rm -rf "$STAGING"
+        return 1
+    }
+    rmdir "$STAGING"
+    ls -t "$CACHE" | tail -n +$((MAX_ENTRIES + 1)) | (cd "$CACHE" && xargs rm -f)
+}
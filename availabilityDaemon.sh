@@ -0,0 +1,208 @@
+#!/bin/bash
+#
+# Keeps an SDK's availability index warm and answers "which uses in this buffer are newer than
+# the soft max" over a Unix domain socket, for on-save feedback in editors. The index is rebuilt
+# in the background whenever a header of the SDK changes or the SDK resolves to another path.
+#
+# usage: availabilityDaemon.sh [-s SDK] [-d STATE_DIR] [-t POLL_SECONDS] -S SOCKET
+#        availabilityDaemon.sh -S SOCKET [-i IOS_SOFT_MAX[,...]] [-m MAC_SOFT_MAX[,...]] [-n NAME] [FILE]
+#
+# The second form is the client: it sends FILE (or standard input, reported as NAME) and prints
+# the warnings. Needs socat; each connection is served by its own process. The daemon is also a
+# checkAvailability.sh -w worker. SOCKET can be any socat address, e.g. TCP-LISTEN:7000,fork for
+# workers on other machines, which need the same checkout at the same path.
+#
+
+set -e
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+. "${SCRIPT_DIR}/availabilityCommon.sh"
+
+SDK=""
+STATE_DIR="${HOME}/Library/Caches/MJGAvailability/daemon"
+POLL_SECONDS=2
+SOCKET=""
+IOS_SOFT_MAX=""
+MAC_SOFT_MAX=""
+NAME=""
+CLIENT=0
+HANDLER=0
+
+while getopts "s:d:t:S:i:m:n:H" OPTION ; do
+    case $OPTION in
+        s) SDK=$OPTARG ;;
+        d) STATE_DIR=$OPTARG ;;
+        t) POLL_SECONDS=$OPTARG ;;
+        S) SOCKET=$OPTARG ;;
+        i) IOS_SOFT_MAX=$OPTARG ; CLIENT=1 ;;
+        m) MAC_SOFT_MAX=$OPTARG ; CLIENT=1 ;;
+        n) NAME=$OPTARG ; CLIENT=1 ;;
+        H) HANDLER=1 ;;
+        *) sed -n '7,8s/^# //p' "$0" >&2 ; exit 2 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+# candidates IOS_FLOOR MAC_FLOOR
+#   Prints the path of the candidate rows of the index for those floors (availability_candidates),
+#   built on first use. The file is named after the fingerprint of the index it comes from, so
+#   that a refresh never replaces the candidates of a request being served.
+candidates() {
+    local FILE
+    set -- "${1:-0}" "${2:-0}"
+    FILE="${STATE_DIR}/candidates-$(head -1 "${STATE_DIR}/index" | cut -d' ' -f2)-$1-$2"
+    if [ ! -f "$FILE" ]; then
+        availability_candidates "${STATE_DIR}/index" "$1" "$2" > "${STATE_DIR}/candidates.$$"
+        # The index may have been rebuilt in the meantime.
+        FILE="${STATE_DIR}/candidates-$(head -1 "${STATE_DIR}/candidates.$$" | cut -d' ' -f2)-$1-$2"
+        mv -f "${STATE_DIR}/candidates.$$" "$FILE"
+    fi
+    echo "$FILE"
+}
+
+# One connection: a "<ios soft max> <mac soft max> <name>" line, then the buffer to check.
+if [ $HANDLER -eq 1 ]; then
+    STATE_DIR=$AVAILABILITY_DAEMON_STATE
+    read -r IOS_SOFT_MAX MAC_SOFT_MAX NAME
+    # A shard of checkAvailability.sh -w: "@shard <ios floor> <mac floor> <index fingerprint>",
+    # then NUL-separated ios= / mac= / source triples. The findings are followed by "@done", so
+    # that a worker dying halfway is told apart from a clean shard. A shard meant for another
+    # index is answered with "@mismatch <fingerprint of this one>".
+    if [ "$IOS_SOFT_MAX" = "@shard" ]; then
+        read -r MAC_FLOOR FINGERPRINT <<< "$NAME"
+        CANDIDATES=$(candidates "$MAC_SOFT_MAX" "$MAC_FLOOR")
+        if [ "$(head -1 "$CANDIDATES")" != "#availability-index ${FINGERPRINT}" ]; then
+            echo "@mismatch $(head -1 "$CANDIDATES" | cut -d' ' -f2)"
+            exit 0
+        fi
+        SHARD=$(mktemp)
+        trap 'rm -f "$SHARD"' EXIT
+        cat > "$SHARD"
+        # Batches of at least 16 TUs, about four per core, as in checkAvailability.sh.
+        JOBS=$(getconf _NPROCESSORS_ONLN)
+        BATCH=$(( $(tr -cd '\0' < "$SHARD" | wc -c) / 3 / (4 * JOBS) + 1 ))
+        if [ $BATCH -lt 16 ]; then
+            BATCH=16
+        fi
+        xargs -0 -P "$JOBS" -n $((3 * BATCH)) bash -c '. "$0" && availability_scan "$@"' \
+            "${SCRIPT_DIR}/availabilityCommon.sh" "${STATE_DIR}/table" "$CANDIDATES" < "$SHARD"
+        echo "@done"
+        exit 0
+    fi
+    BUFFER=$(mktemp)
+    trap 'rm -f "$BUFFER"' EXIT
+    cat > "$BUFFER"
+    # "-" leaves a platform unchecked.
+    IOS_SOFT_MAX=${IOS_SOFT_MAX#-}
+    MAC_SOFT_MAX=${MAC_SOFT_MAX#-}
+    if [ -n "$IOS_SOFT_MAX" ]; then
+        IOS_SOFT_MAX=$(availability_soft_max_values IPHONE "$IOS_SOFT_MAX" "${STATE_DIR}/table" 2>&1) || {
+            echo "error: ${IOS_SOFT_MAX}"
+            exit 0
+        }
+    fi
+    if [ -n "$MAC_SOFT_MAX" ]; then
+        MAC_SOFT_MAX=$(availability_soft_max_values MAC "$MAC_SOFT_MAX" "${STATE_DIR}/table" 2>&1) || {
+            echo "error: ${MAC_SOFT_MAX}"
+            exit 0
+        }
+    fi
+    # The lists are ascending, so their first value is the floor.
+    CANDIDATES=$(candidates "${IOS_SOFT_MAX%%,*}" "${MAC_SOFT_MAX%%,*}")
+    availability_scan "${STATE_DIR}/table" "$CANDIDATES" \
+        "ios=${IOS_SOFT_MAX:-0}" "mac=${MAC_SOFT_MAX:-0}" "$BUFFER" | \
+        awk -v buffer="$BUFFER" -v name="$NAME" '{ print name substr($0, length(buffer) + 1) }' | \
+        sort -t: -k2,2n -k3,3n
+    exit 0
+fi
+
+if [ -z "$SOCKET" ]; then
+    sed -n '7,8s/^# //p' "$0" >&2
+    exit 2
+fi
+
+if [ $CLIENT -eq 1 ] || [ $# -gt 0 ]; then
+    if [ $# -gt 0 ]; then
+        NAME=${NAME:-$1}
+        exec < "$1"
+    fi
+    { echo "${IOS_SOFT_MAX:--} ${MAC_SOFT_MAX:--} ${NAME:-<stdin>}" ; cat ; } | \
+        socat -t 30 - "$(availability_socket_address CONNECT "$SOCKET")"
+    exit 0
+fi
+
+mkdir -p "$STATE_DIR"
+
+# The SDK, symbolic links resolved, so that switching to another Xcode changes it. Without -s
+# it follows xcode-select.
+resolved_sdk() {
+    if [ -n "$SDK" ]; then
+        (cd "$SDK" && pwd -P)
+    else
+        (cd "$(xcrun --sdk iphoneos --show-sdk-path)" && pwd -P)
+    fi
+}
+
+# Rebuilds the index when it is missing, when the SDK resolves to another path, or when a header
+# or directory newer than the index (a header added, changed, removed or renamed) changed the
+# fingerprint of the SDK. Requests being served keep the files they opened; the next ones see
+# the new index. Candidates of older indexes are removed once no request can still be using
+# them. When the SDK can't be resolved or indexed, the error is logged and the current index
+# kept, to try again on the next poll.
+refresh() {
+    local SDK_PATH
+    local FINGERPRINT
+    SDK_PATH=$(resolved_sdk) || {
+        echo "Can't resolve the SDK, keeping the current index" >&2
+        return 0
+    }
+    find "$STATE_DIR" -name 'candidates[-.]*' ! -name "candidates-$(head -1 "${STATE_DIR}/index" 2>/dev/null | cut -d' ' -f2)-*" \
+        -mmin +60 -exec rm -f {} + 2>/dev/null || true
+    if [ -f "${STATE_DIR}/index" ] && [ "$SDK_PATH" = "$(cat "${STATE_DIR}/sdk" 2>/dev/null)" ] && \
+        [ -z "$(find -L "${SDK_PATH}/usr/include" "${SDK_PATH}/System/Library/Frameworks" \
+            \( -name '*.h' -o -type d \) -newer "${STATE_DIR}/index" -print 2>/dev/null | head -1)" ]; then
+        return 0
+    fi
+    FINGERPRINT=$(availability_sdk_fingerprint "$SDK_PATH") || {
+        echo "Can't read ${SDK_PATH}, keeping the current index" >&2
+        return 0
+    }
+    if [ -f "${STATE_DIR}/index" ] && [ "$(head -1 "${STATE_DIR}/index")" = "#availability-index ${FINGERPRINT}" ]; then
+        touch "${STATE_DIR}/index"
+    else
+        echo "Indexing ${SDK_PATH}" >&2
+        # An SDK without a version table is one being installed or removed.
+        if ! availability_table "$SDK_PATH" > "${STATE_DIR}/table.$$" || [ ! -s "${STATE_DIR}/table.$$" ] || \
+            ! availability_index "$SDK_PATH" "$(getconf _NPROCESSORS_ONLN)" > "${STATE_DIR}/index.$$" ; then
+            echo "Indexing ${SDK_PATH} failed, keeping the current index" >&2
+            rm -f "${STATE_DIR}/table.$$" "${STATE_DIR}/index.$$"
+            return 0
+        fi
+        mv -f "${STATE_DIR}/table.$$" "${STATE_DIR}/table"
+        mv -f "${STATE_DIR}/index.$$" "${STATE_DIR}/index"
+    fi
+    echo "$SDK_PATH" > "${STATE_DIR}/sdk.$$"
+    mv -f "${STATE_DIR}/sdk.$$" "${STATE_DIR}/sdk"
+}
+
+refresh
+if [ ! -f "${STATE_DIR}/index" ]; then
+    exit 2
+fi
+
+export AVAILABILITY_DAEMON_STATE=$STATE_DIR
+export AVAILABILITY_DAEMON_SCRIPT="${SCRIPT_DIR}/$(basename "$0")"
+case $SOCKET in
+    *:*) LISTEN=$SOCKET ;;
+    *) LISTEN="UNIX-LISTEN:${SOCKET},fork,unlink-early,mode=600" ;;
+esac
+socat "$LISTEN" SYSTEM:'exec "$AVAILABILITY_DAEMON_SCRIPT" -H' &
+LISTENER=$!
+trap 'kill $LISTENER 2>/dev/null ; rm -f "$SOCKET"' EXIT
+trap 'exit 0' INT TERM
+
+echo "Listening on ${SOCKET}" >&2
+while kill -0 $LISTENER 2>/dev/null ; do
+    sleep "$POLL_SECONDS"
+    refresh
+done
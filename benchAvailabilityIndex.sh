@@ -0,0 +1,106 @@
+#!/bin/bash
+#
+# Measures the availability index at SDK scale: builds a stub SDK with DECLARATIONS symbols,
+# then reports the wall time and peak RSS of indexing it, of checkAvailability.sh scanning a
+# synthetic corpus against the index, and of indexAvailability.sh -q lookups.
+#
+# usage: benchAvailabilityIndex.sh [-n DECLARATIONS] [-t TUS] [-u USES_PER_TU] [-q QUERIES] [-s SOFT_MAX] [-k]
+#
+# Peak RSS needs /usr/bin/time; it shows n/a without it.
+#
+
+set -e
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+
+DECLARATIONS=1000000
+TUS=2000
+USES=50
+QUERIES=1000
+SOFT_MAX=8.0
+KEEP=0
+
+while getopts "n:t:u:q:s:k" OPTION ; do
+    case $OPTION in
+        n) DECLARATIONS=$OPTARG ;;
+        t) TUS=$OPTARG ;;
+        u) USES=$OPTARG ;;
+        q) QUERIES=$OPTARG ;;
+        s) SOFT_MAX=$OPTARG ;;
+        k) KEEP=1 ;;
+        *) sed -n '7s/^# //p' "$0" >&2 ; exit 1 ;;
+    esac
+done
+
+WORK=$(mktemp -d)
+if [ $KEEP -eq 0 ]; then
+    trap 'rm -rf "$WORK"' EXIT
+else
+    echo "Keeping ${WORK}"
+fi
+
+if [ -x /usr/bin/time ] && /usr/bin/time -l true > /dev/null 2>&1 ; then
+    TIME_RSS="/usr/bin/time -l"
+elif [ -x /usr/bin/time ] && /usr/bin/time -v true > /dev/null 2>&1 ; then
+    TIME_RSS="/usr/bin/time -v"
+else
+    TIME_RSS=""
+fi
+
+now() {
+    perl -MTime::HiRes=time -e 'printf "%.6f\n", time'
+}
+
+"${SCRIPT_DIR}/makeStubSDK.sh" -n "$DECLARATIONS" "${WORK}/sdk"
+
+mkdir -p "${WORK}/corpus"
+awk -v tus="$TUS" -v uses="$USES" -v queries="$QUERIES" -v decls="$DECLARATIONS" -v dir="${WORK}" '
+    function symbol(i) {
+        return (i % 4 == 3 ? "StubConstant" : "StubFunction") i
+    }
+
+    BEGIN {
+        srand(1)
+        printf "[" > (dir "/compile_commands.json")
+        for (t = 0; t < tus; t++) {
+            file = sprintf("%s/corpus/tu%d.m", dir, t)
+            printf "void tu%d(void) {\n", t > file
+            for (u = 0; u < uses; u++)
+                printf "    %s;\n", symbol(int(rand() * decls)) > file
+            print "}" > file
+            close(file)
+            printf "%s\n {\"directory\": \"%s/corpus\", \"file\": \"%s\", \"command\": \"clang -c %s\"}",
+                (t ? "," : ""), dir, file, file > (dir "/compile_commands.json")
+        }
+        print "]" > (dir "/compile_commands.json")
+        for (q = 0; q < queries; q++)
+            print symbol(int(rand() * decls)) > (dir "/queries")
+    }'
+
+# run NAME OPERATIONS COMMAND...
+#   Prints the wall time, peak RSS and throughput of COMMAND, which performs OPERATIONS lookups.
+run() {
+    local NAME=$1
+    local OPERATIONS=$2
+    shift 2
+    local START
+    local END
+    START=$(now)
+    $TIME_RSS "$@" > "${WORK}/${NAME}.out" 2> "${WORK}/${NAME}.log" || [ $? -eq 1 ]
+    END=$(now)
+    awk -v name="$NAME" -v operations="$OPERATIONS" -v start="$START" -v end="$END" '
+        /maximum resident set size/ { rss = $1 / 1024 ; if (rss > peak) peak = rss }
+        /Maximum resident set size/ { if ($NF > peak) peak = $NF }
+        END {
+            wall = end - start
+            printf "%-8s %9.2f %12s %14s\n", name, wall, peak ? sprintf("%d", peak) : "n/a",
+                operations ? sprintf("%d", operations / wall) : "-"
+        }' "${WORK}/${NAME}.log"
+}
+
+printf "%-8s %9s %12s %14s\n" phase "wall(s)" "peak RSS(KB)" "lookups/s"
+run index 0 "${SCRIPT_DIR}/indexAvailability.sh" -s "${WORK}/sdk" -o "${WORK}/index"
+run scan $((TUS * USES)) "${SCRIPT_DIR}/checkAvailability.sh" -p "${WORK}/compile_commands.json" \
+    -s "${WORK}/sdk" -x "${WORK}/index" -i "$SOFT_MAX"
+run query "$QUERIES" xargs "${SCRIPT_DIR}/indexAvailability.sh" -o "${WORK}/index" -q < "${WORK}/queries"
+echo "$(($(wc -l < "${WORK}/index") - 1)) index rows, $(grep -c 'too new' "${WORK}/scan.out" || true) too-new uses"
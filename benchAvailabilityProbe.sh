@@ -0,0 +1,145 @@
+#!/bin/bash
+#
+# Measures the runtime checks of MJGAvailabilityProbe.h: builds a shared library exporting
+# one of two weak imported symbols, then times each check from several threads at once.
+#
+# usage: benchAvailabilityProbe.sh [-t THREADS] [-n CHECKS_PER_THREAD] [-k]
+#
+# CC selects the compiler (default cc). Needs Linux (ELF weak symbols, pthread barriers). Columns
+# are nanoseconds per check as seen by one thread, timed by the thread itself and averaged over
+# the threads, while all threads check concurrently.
+#
+
+set -e
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+
+THREADS=$(getconf _NPROCESSORS_ONLN)
+CHECKS=10000000
+KEEP=0
+CC=${CC:-cc}
+
+while getopts "t:n:k" OPTION ; do
+    case $OPTION in
+        t) THREADS=$OPTARG ;;
+        n) CHECKS=$OPTARG ;;
+        k) KEEP=1 ;;
+        *) sed -n '6s/^# //p' "$0" >&2 ; exit 1 ;;
+    esac
+done
+
+WORK=$(mktemp -d)
+if [ $KEEP -eq 0 ]; then
+    trap 'rm -rf "$WORK"' EXIT
+else
+    echo "Keeping ${WORK}"
+fi
+
+cat > "${WORK}/probed.c" << 'EOF'
+void ProbePresent(void) {}
+EOF
+
+# ProbeAbsent is declared weak but exported by nothing, like an API of a newer OS.
+cat > "${WORK}/bench.c" << 'EOF'
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "MJGAvailabilityProbe.h"
+
+extern void ProbePresent(void) __attribute__((weak));
+extern void ProbeAbsent(void) __attribute__((weak));
+
+#define NOINLINE __attribute__((noinline))
+
+NOINLINE static int weak_present(void) { return API_IS_AVAILABLE(ProbePresent); }
+NOINLINE static int weak_absent(void) { return API_IS_AVAILABLE(ProbeAbsent); }
+NOINLINE static int site_present(void) { return API_SYMBOL_IS_AVAILABLE("ProbePresent"); }
+NOINLINE static int site_absent(void) { return API_SYMBOL_IS_AVAILABLE("ProbeAbsent"); }
+NOINLINE static int table_present(void) { return MJGAvailabilityLookup("ProbePresent") != 0; }
+NOINLINE static int table_absent(void) { return MJGAvailabilityLookup("ProbeAbsent") != 0; }
+NOINLINE static int dlsym_present(void) { return dlsym(RTLD_DEFAULT, "ProbePresent") != 0; }
+NOINLINE static int dlsym_absent(void) { return dlsym(RTLD_DEFAULT, "ProbeAbsent") != 0; }
+
+static const struct {
+    const char *name;
+    int (*check)(void);
+} checks[] = {
+    { "API_IS_AVAILABLE present", weak_present },
+    { "API_IS_AVAILABLE absent", weak_absent },
+    { "API_SYMBOL_IS_AVAILABLE present", site_present },
+    { "API_SYMBOL_IS_AVAILABLE absent", site_absent },
+    { "MJGAvailabilityLookup present", table_present },
+    { "MJGAvailabilityLookup absent", table_absent },
+    { "dlsym present", dlsym_present },
+    { "dlsym absent", dlsym_absent },
+};
+
+static long count;
+static int (*current)(void);
+static pthread_barrier_t barrier;
+
+struct result {
+    long available;
+    double elapsed;
+};
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Each thread times its own loop: main may be scheduled after the threads leave the barrier.
+static void *run(void *arg) {
+    struct result *result = arg;
+    long available = 0;
+    pthread_barrier_wait(&barrier);
+    double start = now();
+    for (long i = 0; i < count; i++)
+        available += current();
+    result->elapsed = now() - start;
+    result->available = available;
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    int threads = atoi(argv[1]);
+    long checks_per_thread = atol(argv[2]);
+    pthread_t thread[threads];
+    struct result result[threads];
+    for (size_t c = 0; c < sizeof(checks) / sizeof(checks[0]); c++) {
+        // dlsym is orders of magnitude slower, keep its run short
+        count = c >= 6 ? checks_per_thread / 100 : checks_per_thread;
+        current = checks[c].check;
+        pthread_barrier_init(&barrier, NULL, threads + 1);
+        for (int t = 0; t < threads; t++)
+            pthread_create(&thread[t], NULL, run, &result[t]);
+        pthread_barrier_wait(&barrier);
+        long available = 0;
+        double elapsed = 0;
+        for (int t = 0; t < threads; t++) {
+            pthread_join(thread[t], NULL);
+            available += result[t].available;
+            elapsed += result[t].elapsed;
+        }
+        pthread_barrier_destroy(&barrier);
+        printf("%-34s %8.2f %s\n", checks[c].name, elapsed / threads / count,
+               available == (long)threads * count ? "available" : available == 0 ? "unavailable" : "MIXED");
+    }
+    return 0;
+}
+EOF
+
+cd "$WORK"
+$CC -O2 -shared -fPIC -o libprobed.so probed.c
+# Only weak references keep libprobed, so it must not be dropped as unneeded.
+$CC -O2 -std=gnu99 -I"$SCRIPT_DIR" -o bench bench.c "${SCRIPT_DIR}/MJGAvailabilityProbe.c" \
+    -L. -Wl,--no-as-needed -lprobed -Wl,-rpath,"$WORK" -lpthread -ldl
+
+echo "${THREADS} threads, ${CHECKS} checks per thread ($($CC --version | head -1))"
+printf '%-34s %8s\n' "check" "ns"
+./bench "$THREADS" "$CHECKS"
@@ -0,0 +1,113 @@
+#!/bin/bash
+#
+# Compares what a C++ TU pays for availability checks through the CF_AVAILABLE macro chain of
+# the hacked CFAvailability.h and through the constexpr table of MJGAvailabilityTable.hpp: builds
+# the same synthetic corpus both ways and reports compile wall time and too-new warnings.
+#
+# usage: benchAvailabilityTable.sh [-t TUS] [-u USES_PER_TU] [-s SOFT_MAX] [-S SDK] [-k]
+#
+# CXX selects the compiler (default c++). The macro side compiles against a stub SDK whose
+# Availability.h is a few hundred lines; pass a real SDK, patched with deployPatch.sh, with -S
+# to measure its Availability.h and AvailabilityInternal.h.
+#
+
+set -e
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+. "${SCRIPT_DIR}/availabilityCommon.sh"
+
+TUS=200
+USES=50
+SOFT_MAX=80000
+SDK=""
+KEEP=0
+CXX=${CXX:-c++}
+
+while getopts "t:u:s:S:k" OPTION ; do
+    case $OPTION in
+        t) TUS=$OPTARG ;;
+        u) USES=$OPTARG ;;
+        s) SOFT_MAX=$OPTARG ;;
+        S) SDK=$OPTARG ;;
+        k) KEEP=1 ;;
+        *) sed -n '7s/^# //p' "$0" >&2 ; exit 1 ;;
+    esac
+done
+
+WORK=$(mktemp -d)
+if [ $KEEP -eq 0 ]; then
+    trap 'rm -rf "$WORK"' EXIT
+else
+    echo "Keeping ${WORK}"
+fi
+
+now() {
+    perl -MTime::HiRes=time -e 'printf "%.6f\n", time'
+}
+
+if [ -z "$SDK" ]; then
+    SDK="${WORK}/sdk"
+    "${SCRIPT_DIR}/makeStubSDK.sh" -n 1 -c "${SCRIPT_DIR}/CFAvailability-hacked.h" "$SDK"
+fi
+"${SCRIPT_DIR}/generateAvailabilityTable.sh" -s "$SDK" -o "${WORK}/MJGAvailabilityTable.hpp"
+
+# Both corpora declare and call the same functions with the same iOS versions.
+mkdir -p "${WORK}/macro" "${WORK}/table"
+availability_versions IPHONE $(availability_headers "$SDK") | \
+    awk -v tus="$TUS" -v uses="$USES" -v dir="$WORK" '
+        { version[n++] = $1 }
+        END {
+            srand(1)
+            for (t = 0; t < tus; t++) {
+                macro = sprintf("%s/macro/tu%d.cpp", dir, t)
+                table = sprintf("%s/table/tu%d.cpp", dir, t)
+                print "#include <CoreFoundation/CFAvailability.h>\n" > macro
+                print "#include \"MJGAvailabilityTable.hpp\"\n\nusing namespace mjg::availability;\n" > table
+                for (u = 0; u < uses; u++) {
+                    v = version[int(rand() * n)]
+                    printf "void api%d() CF_AVAILABLE_IOS(%s);\n", u, v > macro
+                    printf "void api%d();\n", u > table
+                    call[u] = v
+                }
+                printf "\nvoid tu%d() {\n", t > macro
+                printf "\nvoid tu%d() {\n", t > table
+                for (u = 0; u < uses; u++) {
+                    printf "    api%d();\n", u > macro
+                    printf "    require<Platform::iOS, ios::v%s>();\n    api%d();\n", call[u], u > table
+                }
+                print "}" > macro
+                print "}" > table
+                close(macro)
+                close(table)
+            }
+        }'
+
+# run_config NAME [FLAGS...]
+run_config() {
+    local NAME=$1
+    shift
+    local START
+    local END
+    local TU
+    START=$(now)
+    for TU in "${WORK}/${NAME}"/*.cpp ; do
+        $CXX -std=c++17 -c "$@" -D__ENVIRONMENT_IPHONE_OS_VERSION_MIN_REQUIRED__=70000 \
+            -D__IPHONE_OS_VERSION_SOFT_MAX_REQUIRED=${SOFT_MAX} "$TU" -o "${TU%.cpp}.o" 2>> "${WORK}/${NAME}.log" || {
+            tail -20 "${WORK}/${NAME}.log" >&2
+            exit 1
+        }
+    done
+    END=$(now)
+    awk -v name="$NAME" -v tus="$TUS" -v start="$START" -v end="$END" '
+        /only available/ { toonew++ }
+        END {
+            wall = end - start
+            printf "%-8s %6d %9.2f %10.2f %9d\n", name, tus, wall, wall * 1000 / tus, toonew
+        }' "${WORK}/${NAME}.log"
+}
+
+: > "${WORK}/macro.log"
+: > "${WORK}/table.log"
+printf "%-8s %6s %9s %10s %9s\n" config TUs "wall(s)" "per-TU(ms)" too-new
+run_config macro -isysroot "$SDK" -isystem "${SDK}/usr/include"
+run_config table -I"$WORK"
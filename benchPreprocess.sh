@@ -0,0 +1,142 @@
+#!/bin/bash
+#
+# Measures what the hack costs per compile: builds a stub SDK, compiles a synthetic corpus
+# against the stock CFAvailability.h and against CFAvailability-hacked.h, and reports
+# wall time, peak RSS, -ftime-trace preprocessing share and preprocessor statistics.
+#
+# usage: benchPreprocess.sh [-t TUS] [-n DECLARATIONS] [-u USES_PER_TU] [-s SOFT_MAX] [-k]
+#
+# CC selects the compiler (default clang). The -ftime-trace and preprocessor statistics
+# columns, and the precompiled header run, need clang; they show n/a with other compilers.
+#
+
+set -e
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+
+TUS=200
+DECLARATIONS=5000
+USES=50
+SOFT_MAX=70000
+KEEP=0
+CC=${CC:-clang}
+
+while getopts "t:n:u:s:k" OPTION ; do
+    case $OPTION in
+        t) TUS=$OPTARG ;;
+        n) DECLARATIONS=$OPTARG ;;
+        u) USES=$OPTARG ;;
+        s) SOFT_MAX=$OPTARG ;;
+        k) KEEP=1 ;;
+        *) sed -n '7s/^# //p' "$0" >&2 ; exit 1 ;;
+    esac
+done
+
+WORK=$(mktemp -d)
+if [ $KEEP -eq 0 ]; then
+    trap 'rm -rf "$WORK"' EXIT
+else
+    echo "Keeping ${WORK}"
+fi
+
+IS_CLANG=0
+if $CC --version 2>/dev/null | grep -q clang ; then
+    IS_CLANG=1
+fi
+
+if [ -x /usr/bin/time ] && /usr/bin/time -l true > /dev/null 2>&1 ; then
+    TIME_RSS="/usr/bin/time -l"
+elif [ -x /usr/bin/time ] && /usr/bin/time -v true > /dev/null 2>&1 ; then
+    TIME_RSS="/usr/bin/time -v"
+else
+    TIME_RSS=""
+fi
+
+now() {
+    perl -MTime::HiRes=time -e 'printf "%.6f\n", time'
+}
+
+"${SCRIPT_DIR}/makeStubSDK.sh" -n "$DECLARATIONS" -c "${SCRIPT_DIR}/CFAvailability.h" "${WORK}/stock"
+"${SCRIPT_DIR}/makeStubSDK.sh" -n "$DECLARATIONS" -c "${SCRIPT_DIR}/CFAvailability-hacked.h" "${WORK}/hacked"
+
+mkdir -p "${WORK}/corpus"
+awk -v tus="$TUS" -v uses="$USES" -v decls="$DECLARATIONS" -v dir="${WORK}/corpus" '
+    BEGIN {
+        srand(1)
+        for (t = 0; t < tus; t++) {
+            file = sprintf("%s/tu%d.c", dir, t)
+            print "#include <Stub/Stub.h>\n" > file
+            printf "int tu%d(void) {\n    int sum = 0;\n", t > file
+            for (u = 0; u < uses; u++) {
+                i = int(rand() * decls)
+                if (i % 4 == 3)
+                    printf "    sum += StubConstant%d;\n", i > file
+                else
+                    printf "    StubFunction%d();\n", i > file
+            }
+            print "    return sum;\n}" > file
+            close(file)
+        }
+    }'
+
+FLAGS=(-c -D__ENVIRONMENT_IPHONE_OS_VERSION_MIN_REQUIRED__=70000)
+if [ $IS_CLANG -eq 1 ]; then
+    FLAGS+=(-ftime-trace -ftime-trace-granularity=0 -Xclang -print-stats)
+fi
+
+# run_config NAME SDK [EXTRA_FLAGS...]
+run_config() {
+    local NAME=$1
+    local SDK=$2
+    shift 2
+    local OUT="${WORK}/out/${NAME}"
+    local START
+    local END
+    local TU
+    mkdir -p "$OUT"
+
+    START=$(now)
+    for TU in "${WORK}"/corpus/*.c ; do
+        TU=$(basename "$TU" .c)
+        $TIME_RSS $CC "${FLAGS[@]}" -isystem "${SDK}/usr/include" "$@" \
+            "${WORK}/corpus/${TU}.c" -o "${OUT}/${TU}.o" 2> "${OUT}/${TU}.log" || {
+            head -20 "${OUT}/${TU}.log" >&2
+            exit 1
+        }
+    done
+    END=$(now)
+
+    cat "${OUT}"/*.log | awk -v name="$NAME" -v tus="$TUS" -v start="$START" -v end="$END" '
+        /maximum resident set size/ { rss = $1 / 1024 ; if (rss > peak) peak = rss }
+        /Maximum resident set size/ { if ($NF > peak) peak = $NF }
+        / macros expanded, / { expanded += $1 ; stats = 1 }
+        / directives found/ { directives += $1 }
+        /only available from/ { toonew++ }
+        END {
+            wall = end - start
+            printf "%-8s %6d %9.2f %10.2f %12s %16s %12s %9d\n", name, tus, wall, wall * 1000 / tus,
+                peak ? sprintf("%d", peak) : "n/a",
+                stats ? sprintf("%d", expanded) : "n/a",
+                stats ? sprintf("%d", directives) : "n/a", toonew
+        }' | tr '\n' ' '
+
+    if [ $IS_CLANG -eq 1 ] && command -v jq > /dev/null ; then
+        cat "${OUT}"/*.json | jq -s -r '
+            [.[].traceEvents[] | select(.name == "Total Source") | .dur] as $source
+            | [.[].traceEvents[] | select(.name == "Total ExecuteCompiler") | .dur] as $total
+            | "\(($source | add) * 100 / ($total | add) | floor)%"'
+    else
+        echo "n/a"
+    fi
+}
+
+printf "%-8s %6s %9s %10s %12s %16s %12s %9s %s\n" config TUs "wall(s)" "per-TU(ms)" "peak RSS(KB)" \
+    "macros expanded" directives too-new "PP share"
+run_config stock "${WORK}/stock" -D__IPHONE_OS_VERSION_SOFT_MAX_REQUIRED=${SOFT_MAX}
+run_config hacked "${WORK}/hacked" -D__IPHONE_OS_VERSION_SOFT_MAX_REQUIRED=${SOFT_MAX}
+
+if [ $IS_CLANG -eq 1 ]; then
+    PCH=$(CC=$CC "${SCRIPT_DIR}/buildAvailabilityPCH.sh" -s "${WORK}/hacked" -l c -d "${WORK}/pch" "$SOFT_MAX" -- \
+        -D__ENVIRONMENT_IPHONE_OS_VERSION_MIN_REQUIRED__=70000 | cut -d' ' -f2-)
+    run_config pch "${WORK}/hacked" $PCH
+fi
@@ -0,0 +1,107 @@
+#!/bin/bash
+#
+# Precompiles MJGAvailability.h and the hacked CFAvailability.h once per soft max value,
+# so every target sharing a soft max reuses the same binary instead of re-lexing the headers.
+#
+# usage: buildAvailabilityPCH.sh [-s SDK] [-p iphoneos|macosx] [-l LANGUAGE] [-d CACHE_DIR] SOFT_MAX... [-- CFLAGS...]
+#
+# Prints one "<soft max> -include-pch <file>" line per value. CFLAGS must match the flags
+# the targets compile with (-arch, -m*-version-min, ...), they are part of the cache key.
+# LANGUAGE is the language of the targets (objective-c, c, objective-c++ or c++), objective-c
+# by default. The key covers the contents of every header the PCH includes (listed with -M), so
+# the PCH doesn't record their timestamps: touching a header, or copying the cache to another
+# machine, doesn't invalidate it, but editing one does.
+#
+
+set -e
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+. "${SCRIPT_DIR}/availabilityCommon.sh"
+
+SDK=""
+PLATFORM="iphoneos"
+LANGUAGE="objective-c"
+CACHE_DIR="${HOME}/Library/Caches/MJGAvailability"
+CC=${CC:-"xcrun clang"}
+
+while getopts "s:p:l:d:" OPTION ; do
+    case $OPTION in
+        s) SDK=$OPTARG ;;
+        p) PLATFORM=$OPTARG ;;
+        l) LANGUAGE=$OPTARG ;;
+        d) CACHE_DIR=$OPTARG ;;
+        *) sed -n '6s/^# //p' "$0" >&2 ; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+SOFT_MAXES=""
+while [ $# -gt 0 ] && [ "$1" != "--" ]; do
+    SOFT_MAXES="$SOFT_MAXES $1"
+    shift
+done
+if [ "$1" == "--" ]; then
+    shift
+fi
+CFLAGS=("$@")
+
+case $PLATFORM in
+    iphoneos) MACRO_PLATFORM=IPHONE ; SOFT_MAX_MACRO=__IPHONE_OS_VERSION_SOFT_MAX_REQUIRED ;;
+    macosx) MACRO_PLATFORM=MAC ; SOFT_MAX_MACRO=__MAC_OS_X_VERSION_SOFT_MAX_REQUIRED ;;
+    *) echo "Unknown platform ${PLATFORM}" >&2 ; exit 1 ;;
+esac
+
+case $LANGUAGE in
+    c|objective-c|c++|objective-c++) ;;
+    *) echo "Unknown language ${LANGUAGE}" >&2 ; exit 1 ;;
+esac
+
+if [ -z "$SOFT_MAXES" ]; then
+    sed -n '6s/^# //p' "$0" >&2
+    exit 1
+fi
+if [ -z "$SDK" ]; then
+    SDK=$(xcrun --sdk "$PLATFORM" --show-sdk-path)
+fi
+AVAILABILITY_HEADERS=$(availability_headers "$SDK")
+TABLE=$(availability_versions "$MACRO_PLATFORM" $AVAILABILITY_HEADERS)
+
+mkdir -p "$CACHE_DIR"
+
+for SOFT_MAX in $SOFT_MAXES ; do
+    if ! VALUE=$(availability_version_value "$SOFT_MAX" "$TABLE"); then
+        echo "Unknown ${PLATFORM} version ${SOFT_MAX}" >&2
+        exit 1
+    fi
+
+    PREFIX=$(printf '#define %s %s\n#import "%s"\n#import <CoreFoundation/CFAvailability.h>\n' \
+        "$SOFT_MAX_MACRO" "$VALUE" "${SCRIPT_DIR}/MJGAvailability.h")
+    # Every header the PCH includes, as listed by -M, so that an SDK updated in place (e.g.
+    # TargetConditionals.h or AvailabilityInternal.h) changes the key.
+    DEPENDENCIES="${CACHE_DIR}/MJGAvailability-${PLATFORM}-${VALUE}.h.$$"
+    echo "$PREFIX" > "$DEPENDENCIES"
+    if ! $CC -M -x "${LANGUAGE}-header" -isysroot "$SDK" "${CFLAGS[@]}" "$DEPENDENCIES" > "${DEPENDENCIES}.d"; then
+        rm -f "$DEPENDENCIES" "${DEPENDENCIES}.d"
+        echo "Could not list the headers of ${SOFT_MAX_MACRO}=${VALUE}" >&2
+        exit 1
+    fi
+    # Make syntax: "target: header header \" lines, spaces in paths escaped.
+    HEADERS=$(awk '{ sub(/\\$/, "") ; printf "%s ", $0 }' "${DEPENDENCIES}.d" | sed 's/^[^:]*: *//' | \
+        awk '{ gsub(/\\ /, "\001") ; for (i = 1; i <= NF; i++) { gsub(/\001/, " ", $i) ; printf "%s%c", $i, 0 } }' | \
+        xargs -0 cat | shasum -a 256)
+    rm -f "${DEPENDENCIES}.d"
+    KEY=$( { echo "$PREFIX" ; echo "$SDK" ; echo "$LANGUAGE" ; echo "${CFLAGS[*]}" ; $CC --version ; \
+        echo "$HEADERS" ; } | shasum -a 256 | cut -c1-16)
+    NAME="${CACHE_DIR}/MJGAvailability-${PLATFORM}-${VALUE}-${KEY}"
+
+    if [ -f "${NAME}.pch" ]; then
+        rm -f "$DEPENDENCIES"
+    else
+        mv -f "$DEPENDENCIES" "${NAME}.h"
+        $CC -x "${LANGUAGE}-header" -Xclang -fno-pch-timestamp -isysroot "$SDK" "${CFLAGS[@]}" "${NAME}.h" \
+            -o "${NAME}.pch.$$"
+        mv -f "${NAME}.pch.$$" "${NAME}.pch"
+    fi
+
+    echo "${VALUE} -include-pch ${NAME}.pch"
+done
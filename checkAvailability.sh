@@ -0,0 +1,408 @@
+#!/bin/bash
+#
+# Finds uses of APIs newer than the soft max without patching the SDK or rebuilding:
+# indexes the availability macros of the SDK headers and scans every translation unit
+# of compile_commands.json in parallel.
+#
+# usage: checkAvailability.sh [-p compile_commands.json] [-s SDK] [-x INDEX] [-i IOS_SOFT_MAX[,...]]
+#                             [-m MAC_SOFT_MAX[,...]] [-j JOBS] [-c CACHE_DIR] [-e MAX_CACHE_ENTRIES]
+#                             [-g GIT_RANGE] [-w WORKER_SOCKET[,...]] [-M METRICS_FILE] [-T TRACE_FILE]
+#                             [-C SOFT_MAX_CONFIG]
+#
+# -x reuses the index written by indexAvailability.sh instead of re-reading the SDK headers.
+# -c keeps the findings of every TU in CACHE_DIR, keyed on its content, soft max values and
+# SDK, so unchanged TUs aren't scanned again. The directory can be shared between CI agents.
+# -g only scans the TUs changed by GIT_RANGE (anything git diff takes, e.g. HEAD in a pre-commit
+# hook or origin/main...HEAD for a pull request) or including a changed header, directly or not.
+# Changed headers are scanned too, with the soft max values of the TUs including them.
+# Run it from inside the repository; the include graph is cached in its .git directory.
+# -w spreads the scan over availabilityDaemon.sh workers: TUs are sharded by size, a few shards
+# per worker, and idle workers steal the shards of slow ones. Failed shards are retried on
+# other workers, and scanned locally when no worker is left.
+# -M writes counters, phase durations and latency histograms in the Prometheus text format, and
+# -T the phase, batch and shard spans as Chrome trace events. Batches then run their stages one
+# at a time instead of as a pipeline, to time lexing and checking apart.
+# Run from inside the git repository of the project, the project headers included by the TUs,
+# directly or not, are scanned too, with the soft max values of the TUs including them.
+# #define bodies are scanned where they are defined, not where they are expanded.
+# -i / -m take comma-separated lists to check several soft max values in the same pass.
+# Without -i / -m, the soft max of each TU comes from its command line:
+# -D__IPHONE_OS_VERSION_SOFT_MAX_REQUIRED / -D__MAC_OS_X_VERSION_SOFT_MAX_REQUIRED,
+# or else its -miphoneos-version-min / -mmacosx-version-min / -target deployment target.
+# A deployment target missing from the SDK table is reported, and the TU not checked for it.
+# -C overrides those per target or per directory with a config file read on every run, so that
+# the soft max doesn't have to be compiled in. Lines are "target NAME ios=X mac=Y" or
+# "dir PATH ios=X mac=Y" (either value optional, lists allowed); the last matching line wins.
+# NAME is the target of the TU's object file, the X of its last X.build/ (Xcode) or X.dir/
+# (CMake) directory. PATH is a prefix of the source, relative to the config file.
+# Exits with 1 when too-new API uses are found.
+#
+
+set -e
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+. "${SCRIPT_DIR}/availabilityCommon.sh"
+
+COMPILE_COMMANDS="compile_commands.json"
+SDK=""
+INDEX=""
+IOS_SOFT_MAX=""
+MAC_SOFT_MAX=""
+JOBS=$(getconf _NPROCESSORS_ONLN)
+# Least TUs handed to a worker at a time: small enough that idle workers keep pulling work
+# off the shared queue, large enough to amortize starting the worker. Every batch reads the
+# whole candidate index, so large runs use bigger batches, about four per worker.
+MIN_BATCH=16
+CACHE=""
+MAX_CACHE_ENTRIES=100000
+RANGE=""
+WORKERS=""
+METRICS=""
+TRACE=""
+CONFIG=""
+
+while getopts "p:s:x:i:m:j:c:e:g:w:M:T:C:" OPTION ; do
+    case $OPTION in
+        p) COMPILE_COMMANDS=$OPTARG ;;
+        s) SDK=$OPTARG ;;
+        x) INDEX=$OPTARG ;;
+        i) IOS_SOFT_MAX=$OPTARG ;;
+        m) MAC_SOFT_MAX=$OPTARG ;;
+        j) JOBS=$OPTARG ;;
+        c) CACHE=$OPTARG ;;
+        e) MAX_CACHE_ENTRIES=$OPTARG ;;
+        g) RANGE=$OPTARG ;;
+        w) WORKERS=$OPTARG ;;
+        M) METRICS=$OPTARG ;;
+        T) TRACE=$OPTARG ;;
+        C) CONFIG=$OPTARG ;;
+        *) sed -n '7,10s/^# //p' "$0" >&2 ; exit 2 ;;
+    esac
+done
+
+if [ -z "$SDK" ]; then
+    SDK=$(xcrun --sdk iphoneos --show-sdk-path)
+fi
+
+# Absolute, since the cache helpers change directory.
+if [ -n "$CACHE" ]; then
+    CACHE=$(mkdir -p "$CACHE" && cd "$CACHE" && pwd) || exit 2
+fi
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+if [ -n "$METRICS" ] || [ -n "$TRACE" ]; then
+    export AVAILABILITY_EVENTS="${WORK}/events"
+    : > "$AVAILABILITY_EVENTS"
+fi
+
+START=$(availability_now)
+availability_table "$SDK" > "${WORK}/table"
+if [ -z "$INDEX" ]; then
+    INDEX="${WORK}/index"
+    availability_index "$SDK" "$JOBS" > "$INDEX"
+fi
+
+availability_event index phase "$START" 0
+
+START=$(availability_now)
+IOS_SOFT_MAX=$(availability_soft_max_values IPHONE "$IOS_SOFT_MAX" "${WORK}/table") || exit 2
+MAC_SOFT_MAX=$(availability_soft_max_values MAC "$MAC_SOFT_MAX" "${WORK}/table") || exit 2
+
+if [ -n "$CONFIG" ]; then
+    CONFIG_DIR=$(cd "$(dirname "$CONFIG")" && pwd)
+else
+    CONFIG=/dev/null
+fi
+
+# One "ios=<soft max>" "mac=<soft max>" "<source>" triple per TU, NUL-separated.
+jq -r '.[] | [.directory, .file, (.command // (.arguments | join(" ")))] | @tsv' "$COMPILE_COMMANDS" | \
+    awk -v ios="$IOS_SOFT_MAX" -v mac="$MAC_SOFT_MAX" -v config_dir="$CONFIG_DIR" -v search="${WORK}/search" '
+        function resolve(platform, v) {
+            gsub(/["'\'']/, "", v)
+            sub(/^__(IPHONE|MAC)_/, "", v)
+            if (v ~ /^[0-9][0-9][0-9][0-9]+$/)
+                return v
+            gsub(/\./, "_", v)
+            if (v !~ /_/)
+                v = v "_0"
+            return (platform, v) in value ? value[platform, v] : 0
+        }
+
+        # Resolves a comma-separated list of versions into ascending values, or fails.
+        function resolve_list(platform, list,   n, v, i, j, t, name) {
+            n = split(list, v, ",")
+            for (i = 1; i <= n; i++) {
+                name = v[i]
+                v[i] = resolve(platform, name)
+                if (v[i] == 0) {
+                    printf "Unknown %s version %s in %s\n", platform, name, FILENAME > "/dev/stderr"
+                    exit 2
+                }
+                for (j = i; j > 1 && v[j - 1] > v[j]; j--) {
+                    t = v[j]
+                    v[j] = v[j - 1]
+                    v[j - 1] = t
+                }
+            }
+            list = v[1]
+            for (i = 2; i <= n; i++)
+                list = list "," v[i]
+            return list
+        }
+
+        # Target of the TU: NAME of the last NAME.build/ or NAME.dir/ of its command.
+        function target(command,   name) {
+            name = ""
+            while (match(command, /[^ \/]+\.(build|dir)\//)) {
+                name = substr(command, RSTART, RLENGTH - 1)
+                sub(/\.(build|dir)$/, "", name)
+                command = substr(command, RSTART + RLENGTH)
+            }
+            return name
+        }
+
+        # Writes the -iquote, then -I directories of the TU to the search file, absolute.
+        function search_dirs(directory, file, command,   n, word, i, quote, include, dir) {
+            n = split(command, word, " ")
+            quote = include = ""
+            for (i = 1; i <= n; i++) {
+                dir = ""
+                if (word[i] == "-iquote" || word[i] == "-I") {
+                    dir = word[i + 1]
+                } else if (word[i] ~ /^-iquote./ || word[i] ~ /^-I./) {
+                    dir = word[i]
+                    sub(/^-(iquote|I)/, "", dir)
+                }
+                if (dir == "")
+                    continue
+                gsub(/"/, "", dir)
+                if (dir !~ /^\//)
+                    dir = directory "/" dir
+                if (word[i] ~ /^-iquote/)
+                    quote = quote "\t" dir
+                else
+                    include = include "\t" dir
+            }
+            print file quote include > search
+        }
+
+        function flag(command, pattern,   v) {
+            if (!match(command, pattern))
+                return ""
+            v = substr(command, RSTART, RLENGTH)
+            sub(/^[^=]*=/, "", v)
+            return v
+        }
+
+        BEGIN {
+            FS = "\t"
+            printf "" > search
+        }
+
+        FILENAME == ARGV[1] {
+            split($0, field, " ")
+            value[field[1], field[2]] = field[3]
+            next
+        }
+
+        FILENAME == ARGV[2] {
+            sub(/#.*/, "")
+            n = split($0, field, " ")
+            if (n < 3 || (field[1] != "target" && field[1] != "dir"))
+                next
+            rules++
+            kind[rules] = field[1]
+            pattern[rules] = field[1] == "dir" && field[2] !~ /^\// ? config_dir "/" field[2] : field[2]
+            sub(/\/+$/, "", pattern[rules])
+            for (i = 3; i <= n; i++) {
+                if (field[i] ~ /^ios=/)
+                    rule_ios[rules] = resolve_list("IPHONE", substr(field[i], 5))
+                else if (field[i] ~ /^mac=/)
+                    rule_mac[rules] = resolve_list("MAC", substr(field[i], 5))
+            }
+            next
+        }
+
+        {
+            file = $2 ~ /^\// ? $2 : $1 "/" $2
+            search_dirs($1, file, $3)
+            tu_ios = ios
+            tu_mac = mac
+            if (tu_ios == "") {
+                v = flag($3, "-D *__IPHONE_OS_VERSION_SOFT_MAX_REQUIRED=[^ ]+")
+                if (v == "")
+                    v = flag($3, "-m(iphoneos|ios|ios-simulator)-version-min=[^ ]+")
+                if (v == "" && match($3, /-target[= ][^ ]*-ios[0-9.]+/)) {
+                    v = substr($3, RSTART, RLENGTH)
+                    sub(/.*-ios/, "", v)
+                }
+                tu_ios = v == "" ? 0 : resolve("IPHONE", v)
+                ios_target = v
+            }
+            if (tu_mac == "") {
+                v = flag($3, "-D *__MAC_OS_X_VERSION_SOFT_MAX_REQUIRED=[^ ]+")
+                if (v == "")
+                    v = flag($3, "-mmacosx?-version-min=[^ ]+")
+                if (v == "" && match($3, /-target[= ][^ ]*-macosx?[0-9.]+/)) {
+                    v = substr($3, RSTART, RLENGTH)
+                    sub(/.*-macosx?/, "", v)
+                }
+                tu_mac = v == "" ? 0 : resolve("MAC", v)
+                mac_target = v
+            }
+            tu_target = rules ? target($3) : ""
+            for (r = rules; r > 0; r--) {
+                if (kind[r] == "target" ? tu_target == pattern[r] : index(file "/", pattern[r] "/") == 1) {
+                    if (ios == "" && (r in rule_ios) && !ios_set) {
+                        tu_ios = rule_ios[r]
+                        ios_set = 1
+                    }
+                    if (mac == "" && (r in rule_mac) && !mac_set) {
+                        tu_mac = rule_mac[r]
+                        mac_set = 1
+                    }
+                }
+            }
+            # 0 turns the check off for the platform, expected without a deployment target only.
+            if (tu_ios == 0 && ios_target != "")
+                printf "Unknown IPHONE version %s in the command of %s, not checked for iOS\n", ios_target, file > "/dev/stderr"
+            if (tu_mac == 0 && mac_target != "")
+                printf "Unknown MAC version %s in the command of %s, not checked for OS X\n", mac_target, file > "/dev/stderr"
+            ios_set = mac_set = 0
+            ios_target = mac_target = ""
+            printf "ios=%s%cmac=%s%c%s%c", tu_ios, 0, tu_mac, 0, file, 0
+        }' "${WORK}/table" "$CONFIG" - > "${WORK}/tus"
+
+if [ -n "$RANGE" ]; then
+    git rev-parse --git-dir > /dev/null || exit 2
+    availability_affected_files "$RANGE" "$(git rev-parse --git-common-dir)/availability-includes" "$WORK" \
+        > "${WORK}/affected"
+    tr '\0' '\n' < "${WORK}/tus" | awk -v range="$RANGE" '
+        FILENAME == ARGV[1] {
+            affected[$0]
+            next
+        }
+        FNR % 3 == 1 {
+            ios = $0
+            next
+        }
+        FNR % 3 == 2 {
+            mac = $0
+            next
+        }
+        {
+            tus++
+            if ($0 in affected) {
+                scanned++
+                printf "%s%c%s%c%s%c", ios, 0, mac, 0, $0, 0
+            }
+        }
+        END {
+            printf "git: %d of %d TUs affected by %s\n", scanned, tus, range > "/dev/stderr"
+        }' "${WORK}/affected" - > "${WORK}/tus.affected"
+    mv "${WORK}/tus.affected" "${WORK}/tus"
+fi
+
+# Project headers are scanned too, with the soft max values of the TUs including them.
+if git rev-parse --git-dir > /dev/null 2>&1 ; then
+    if [ ! -e "${WORK}/includes" ]; then
+        availability_include_graph "$(git rev-parse --git-common-dir)/availability-includes" "$WORK" \
+            > "${WORK}/includes"
+    fi
+    availability_project_headers "${WORK}/tus" "${WORK}/includes" "${WORK}/search" > "${WORK}/headers"
+    if [ -n "$RANGE" ]; then
+        # The changed headers, and those including them, with the soft max of the affected TUs.
+        tr '\0' '\n' < "${WORK}/headers" | awk '
+            FILENAME == ARGV[1] {
+                affected[$0]
+                next
+            }
+            FNR % 3 == 1 {
+                ios = $0
+                next
+            }
+            FNR % 3 == 2 {
+                mac = $0
+                next
+            }
+            $0 in affected {
+                if (!($0 in counted)) {
+                    counted[$0]
+                    headers++
+                }
+                printf "%s%c%s%c%s%c", ios, 0, mac, 0, $0, 0
+            }
+            END {
+                printf "git: %d affected headers included by them\n", headers > "/dev/stderr"
+            }' "${WORK}/affected" - > "${WORK}/headers.affected"
+        mv "${WORK}/headers.affected" "${WORK}/headers"
+    fi
+    cat "${WORK}/headers" >> "${WORK}/tus"
+fi
+
+availability_event plan phase "$START" 0
+
+START=$(availability_now)
+if [ -n "$CACHE" ]; then
+    availability_cache_lookup "$CACHE" "$(availability_cache_salt "$INDEX")" "${WORK}/tus" "$WORK"
+else
+    mv "${WORK}/tus" "${WORK}/misses"
+    : > "${WORK}/cached"
+fi
+
+availability_event cache phase "$START" 0
+
+LOCAL="${WORK}/misses"
+: > "${WORK}/remote"
+if [ -n "$WORKERS" ] && [ -s "$LOCAL" ]; then
+    START=$(availability_now)
+    mkdir "${WORK}/workers"
+    availability_distribute "$WORKERS" "$LOCAL" "${WORK}/workers" "$INDEX" > "${WORK}/remote"
+    LOCAL="${WORK}/workers/leftover"
+    availability_event workers phase "$START" 0
+fi
+
+: > "${WORK}/local"
+START=$(availability_now)
+if [ -s "$LOCAL" ]; then
+    availability_candidates "$INDEX" $(availability_floors "$LOCAL") > "${WORK}/candidates"
+    BATCH=$(( $(tr -cd '\0' < "$LOCAL" | wc -c) / 3 / (4 * JOBS) + 1 ))
+    if [ $BATCH -lt $MIN_BATCH ]; then
+        BATCH=$MIN_BATCH
+    fi
+    xargs -0 -P "$JOBS" -n $((3 * BATCH)) bash -c '. "$0" && availability_scan "$@"' \
+        "${SCRIPT_DIR}/availabilityCommon.sh" "${WORK}/table" "${WORK}/candidates" < "$LOCAL" > "${WORK}/local"
+fi
+availability_event scan phase "$START" 0
+cat "${WORK}/remote" "${WORK}/local" > "${WORK}/scanned"
+
+START=$(availability_now)
+
+if [ -n "$CACHE" ]; then
+    # Failing to update the cache must not suppress the findings.
+    availability_cache_store "$CACHE" "$WORK" "${WORK}/scanned" "$MAX_CACHE_ENTRIES" || \
+        echo "warning: could not update the cache in ${CACHE}" >&2
+fi
+
+# A TU listed twice, or a shard run by two workers, reports the same findings twice.
+sort -t: -k1,1 -k2,2n -k3,3n "${WORK}/cached" "${WORK}/scanned" | uniq > "${WORK}/findings"
+
+cat "${WORK}/findings"
+availability_event report phase "$START" 0
+availability_metric findings "$(wc -l < "${WORK}/findings")"
+
+# Written to a temporary file then renamed, so that collectors never read half a file.
+if [ -n "$METRICS" ]; then
+    availability_prometheus "$AVAILABILITY_EVENTS" > "${METRICS}.$$"
+    mv -f "${METRICS}.$$" "$METRICS"
+fi
+if [ -n "$TRACE" ]; then
+    availability_trace_events "$AVAILABILITY_EVENTS" > "${TRACE}.$$"
+    mv -f "${TRACE}.$$" "$TRACE"
+fi
+
+if [ -s "${WORK}/findings" ]; then
+    exit 1
+fi
@@ -1,20 +1,169 @@
 #!/bin/bash
+#
+# Patches CFAvailability.h in every platform SDK of Xcode, keeping the stock header as .orig.
+#
+# usage: deployPatch.sh [-x XCODE_PATH] [-p "PLATFORM..."] [-f HACKED_HEADER] [-v | -r]
+#
+# Every SDK of every platform is patched unless -p is given. -v verifies that every SDK is
+# patched, -r restores the stock headers. SDKs are handled concurrently. Files are replaced
+# with temp + rename, so an interrupted run never leaves a half-written header, SDKs already
+# patched are left alone, and SDKs whose stock header isn't the one the hacked header was
+# generated from are refused. -r only restores over the hacked header given with -f.
+#
 
-set -x
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
 
-XCODE_PATH=$(xcode-select -print-path)
-PLATFORMS="iPhoneOS iPhoneSimulator"
+XCODE_PATH=""
+PLATFORMS=""
+HACKED_HEADER="${SCRIPT_DIR}/CFAvailability-hacked.h"
+MODE=patch
 HEADER_TO_REPLACE="/System/Library/Frameworks/CoreFoundation.framework/Headers/CFAvailability.h"
 
-for PLATFORM in $PLATFORMS ; do
-    
-    SDK=$PLATFORM
-    AVAIL_FILE="${XCODE_PATH}/Platforms/${PLATFORM}.platform/Developer/SDKs/${SDK}.sdk${HEADER_TO_REPLACE}"
-    if [ ! -f "${AVAIL_FILE}.orig" ];
-    then
-        mv ${AVAIL_FILE} ${AVAIL_FILE}.orig
+while getopts "x:p:f:vr" OPTION ; do
+    case $OPTION in
+        x) XCODE_PATH=$OPTARG ;;
+        p) PLATFORMS=$OPTARG ;;
+        f) HACKED_HEADER=$OPTARG ;;
+        v) MODE=verify ;;
+        r) MODE=rollback ;;
+        *) sed -n '5s/^# //p' "$0" >&2 ; exit 2 ;;
+    esac
+done
+
+if [ -z "$XCODE_PATH" ]; then
+    XCODE_PATH=$(xcode-select -print-path)
+fi
+
+file_hash() {
+    shasum -a 256 < "$1" | cut -d' ' -f1
+}
+
+# stock_hash HEADER: hash of HEADER without the MJGAvailability block and trailing blank lines,
+# i.e. of the stock header a hacked header was made from.
+stock_hash() {
+    awk '
+        { line[NR] = $0 }
+        END {
+            n = NR
+            while (n > 0 && line[n] == "")
+                n--
+            for (i = 1; i <= n; i++) {
+                if (line[i] == "//" && line[i + 1] == "//  MJGAvailability start")
+                    skipping = 1
+                if (!skipping)
+                    print line[i]
+                else if (line[i] == "//" && line[i - 1] == "//  MJGAvailability end") {
+                    skipping = 0
+                    if (line[i + 1] == "")
+                        i++
+                }
+            }
+        }' "$1" | shasum -a 256 | cut -d' ' -f1
+}
+
+# install_file SOURCE DESTINATION
+install_file() {
+    cp "$1" "${2}.tmp.$$" && mv -f "${2}.tmp.$$" "$2"
+}
+
+# process_sdk SDK
+process_sdk() {
+    local SDK=$1
+    local AVAIL_FILE="${SDK}${HEADER_TO_REPLACE}"
+    local NAME
+    NAME=$(basename "$SDK")
+
+    if [ ! -f "$AVAIL_FILE" ] && [ ! -f "${AVAIL_FILE}.orig" ]; then
+        echo "${NAME}: no CFAvailability.h, skipped"
+        return 0
     fi
 
-    cp CFAvailability-hacked.h ${AVAIL_FILE}
+    case $MODE in
+        patch)
+            if [ -f "$AVAIL_FILE" ] && [ "$(file_hash "$AVAIL_FILE")" == "$HACKED_HASH" ] \
+                && [ -f "${AVAIL_FILE}.orig" ]; then
+                echo "${NAME}: already patched"
+                return 0
+            fi
+            if [ -f "$AVAIL_FILE" ] && ! grep -q "MJGAvailability start" "$AVAIL_FILE" ; then
+                # Stock header: never patched, or the SDK was updated since and the .orig is stale
+                if [ "$(stock_hash "$AVAIL_FILE")" != "$STOCK_HASH" ]; then
+                    echo "${NAME}: stock CFAvailability.h differs from the one ${HACKED_HEADER} was generated from, regenerate it with generateHackedHeader.sh -c" >&2
+                    return 1
+                fi
+                if [ ! -f "${AVAIL_FILE}.orig" ] || ! cmp -s "$AVAIL_FILE" "${AVAIL_FILE}.orig" ; then
+                    install_file "$AVAIL_FILE" "${AVAIL_FILE}.orig" || return 1
+                fi
+            elif [ ! -f "${AVAIL_FILE}.orig" ] || [ "$(stock_hash "${AVAIL_FILE}.orig")" != "$STOCK_HASH" ]; then
+                echo "${NAME}: installed header is patched but the .orig is missing or does not match ${HACKED_HEADER}" >&2
+                return 1
+            fi
+            install_file "$HACKED_HEADER" "$AVAIL_FILE" || return 1
+            echo "${NAME}: patched"
+            ;;
+        verify)
+            if [ ! -f "$AVAIL_FILE" ] || [ "$(file_hash "$AVAIL_FILE")" != "$HACKED_HASH" ]; then
+                echo "${NAME}: not patched" >&2
+                return 1
+            fi
+            if [ ! -f "${AVAIL_FILE}.orig" ] || [ "$(stock_hash "${AVAIL_FILE}.orig")" != "$STOCK_HASH" ]; then
+                echo "${NAME}: patched, but the .orig is missing or does not match ${HACKED_HEADER}" >&2
+                return 1
+            fi
+            echo "${NAME}: patched"
+            ;;
+        rollback)
+            if [ ! -f "${AVAIL_FILE}.orig" ]; then
+                echo "${NAME}: nothing to roll back"
+                return 0
+            fi
+            # Anything but the hacked header, e.g. the stock header of an updated SDK, is newer
+            # than the .orig.
+            if [ -f "$AVAIL_FILE" ] && [ "$(file_hash "$AVAIL_FILE")" != "$HACKED_HASH" ] \
+                && ! cmp -s "$AVAIL_FILE" "${AVAIL_FILE}.orig" ; then
+                echo "${NAME}: installed CFAvailability.h isn't ${HACKED_HEADER}, left alone with its .orig" >&2
+                return 1
+            fi
+            mv -f "${AVAIL_FILE}.orig" "$AVAIL_FILE" || return 1
+            echo "${NAME}: restored"
+            ;;
+    esac
+}
+
+if [ ! -f "$HACKED_HEADER" ]; then
+    echo "No ${HACKED_HEADER}" >&2
+    exit 1
+fi
+HACKED_HASH=$(file_hash "$HACKED_HEADER")
+STOCK_HASH=$(stock_hash "$HACKED_HEADER")
+
+if [ -z "$PLATFORMS" ]; then
+    for PLATFORM_DIR in "${XCODE_PATH}"/Platforms/*.platform ; do
+        if [ -d "$PLATFORM_DIR" ]; then
+            PLATFORMS="$PLATFORMS $(basename "$PLATFORM_DIR" .platform)"
+        fi
+    done
+fi
+
+# iPhoneOS.sdk is usually a symlink to the versioned SDK, patch each real directory once
+SDKS=$(for PLATFORM in $PLATFORMS ; do
+    for SDK in "${XCODE_PATH}/Platforms/${PLATFORM}.platform/Developer/SDKs"/*.sdk ; do
+        if [ -d "$SDK" ]; then
+            (cd -P "$SDK" && pwd)
+        fi
+    done
+done | sort -u)
+
+PIDS=""
+while read -r SDK ; do
+    if [ -n "$SDK" ]; then
+        process_sdk "$SDK" &
+        PIDS="$PIDS $!"
+    fi
+done <<< "$SDKS"
 
+STATUS=0
+for PID in $PIDS ; do
+    wait "$PID" || STATUS=1
 done
+exit $STATUS
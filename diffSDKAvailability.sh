@@ -0,0 +1,164 @@
+#!/bin/bash
+#
+# Compares the availability macros of two SDK header trees. Prints one
+# "<added|changed|removed>\t<version|internal|cf>\t<macro>\t<definition>" line per change to the
+# __IPHONE_x_y / __MAC_x_y versions, the __AVAILABILITY_INTERNAL__* macros and the CF_* availability
+# macros. Headers are hashed first and only the ones that differ are parsed.
+#
+# usage: diffSDKAvailability.sh [-j JOBS] [-o HACKED_HEADER] OLD_SDK NEW_SDK
+#
+# -o regenerates the hacked header from NEW_SDK when its version table changed.
+# Exits 1 when something changed, like diff.
+#
+
+set -e
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+. "${SCRIPT_DIR}/availabilityCommon.sh"
+
+JOBS=$(getconf _NPROCESSORS_ONLN)
+OUTPUT=""
+
+while getopts "j:o:" OPTION ; do
+    case $OPTION in
+        j) JOBS=$OPTARG ;;
+        o) OUTPUT=$OPTARG ;;
+        *) sed -n '8s/^# //p' "$0" >&2 ; exit 2 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [ $# -ne 2 ] || [ ! -d "$1" ] || [ ! -d "$2" ]; then
+    sed -n '8s/^# //p' "$0" >&2
+    exit 2
+fi
+OLD_SDK=$(cd "$1" && pwd)
+NEW_SDK=$(cd "$2" && pwd)
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+TAB=$(printf '\t')
+
+# header_hashes SDK
+#   Prints "<path relative to SDK>\t<sha256>" for every header of SDK, sorted by path.
+header_hashes() {
+    availability_sdk_headers "$1" | xargs -0 -P "$JOBS" -n 256 shasum -a 256 | \
+        awk -v prefix="$1/" '{ print substr($0, 67 + length(prefix)) "\t" substr($0, 1, 64) }' | \
+        LC_ALL=C sort -t "$TAB" -k1,1
+}
+
+# macro_definitions SDK
+#   Reads relative header paths of SDK NUL-separated, prints "<macro>\t<path>\t<definition>" for
+#   every availability macro they define, with whitespace and comments normalized away.
+macro_definitions() {
+    (cd "$1" && xargs -0 -P "$JOBS" -n 64 awk '
+        FNR == 1 { continued = 0 }
+        continued { text = text " " $0 }
+        !continued {
+            if ($0 !~ /^[ \t]*#[ \t]*define[ \t]/)
+                next
+            text = $0
+        }
+        {
+            if (continued = sub(/\\$/, "", text))
+                next
+            gsub(/\/\*([^*]|\*+[^*\/])*\*+\//, " ", text)
+            sub(/\/\/.*/, "", text)
+            sub(/^[ \t]*#[ \t]*define[ \t]+/, "", text)
+            if (!match(text, /^[A-Za-z_][A-Za-z0-9_]*/))
+                next
+            name = substr(text, 1, RLENGTH)
+            if (name !~ /^__(IPHONE|MAC)_[0-9]+(_[0-9]+)+$/ && name !~ /^__AVAILABILITY_INTERNAL__/ \
+                && !(name ~ /^CF_/ && name ~ /AVAILABLE|DEPRECATED/))
+                next
+            definition = substr(text, RLENGTH + 1)
+            gsub(/[ \t]+/, " ", definition)
+            sub(/^ /, "", definition)
+            sub(/ $/, "", definition)
+            print name "\t" FILENAME "\t" definition
+        }')
+}
+
+# collapse
+#   Turns macro_definitions output into one "<macro>\t<path>\t<definitions>" line per macro, the
+#   distinct definitions (a macro is often defined in several #if branches) sorted and joined by " | ".
+collapse() {
+    LC_ALL=C sort -t "$TAB" -k1,1 -k3,3 -u | awk -F "$TAB" '
+        $1 != name {
+            if (name != "")
+                print name "\t" file "\t" definitions
+            name = $1
+            file = $2
+            definitions = $3
+            next
+        }
+        { definitions = definitions " | " $3 }
+        END {
+            if (name != "")
+                print name "\t" file "\t" definitions
+        }'
+}
+
+header_hashes "$OLD_SDK" > "${WORK}/old.hashes" &
+header_hashes "$NEW_SDK" > "${WORK}/new.hashes"
+wait $!
+
+LC_ALL=C join -t "$TAB" -a 1 -a 2 -e - -o 0,1.2,2.2 "${WORK}/old.hashes" "${WORK}/new.hashes" | \
+    awk -F "$TAB" -v work="$WORK" '
+        $2 == $3 { unchanged++ ; next }
+        $2 == "-" { added++ }
+        $3 == "-" { removed++ }
+        $2 != "-" && $3 != "-" { changed++ }
+        $2 != "-" { printf "%s%c", $1, 0 > (work "/old.headers") }
+        $3 != "-" { printf "%s%c", $1, 0 > (work "/new.headers") }
+        END {
+            printf "headers: %d added, %d changed, %d removed, %d unchanged (skipped)\n", \
+                added, changed, removed, unchanged > "/dev/stderr"
+        }'
+touch "${WORK}/old.headers" "${WORK}/new.headers"
+
+macro_definitions "$OLD_SDK" < "${WORK}/old.headers" | collapse > "${WORK}/old.macros" &
+macro_definitions "$NEW_SDK" < "${WORK}/new.headers" | collapse > "${WORK}/new.macros"
+wait $!
+
+LC_ALL=C join -t "$TAB" -a 1 -a 2 -e - -o 0,1.2,1.3,2.2,2.3 "${WORK}/old.macros" "${WORK}/new.macros" | \
+    awk -F "$TAB" '
+        $3 == $5 { next }
+        {
+            kind = $1 ~ /^__AVAILABILITY_INTERNAL__/ ? "internal" : $1 ~ /^CF_/ ? "cf" : "version"
+            if ($2 == "-")
+                print "added\t" kind "\t" $1 "\t" $5
+            else if ($4 == "-")
+                print "removed\t" kind "\t" $1 "\t" $3
+            else
+                print "changed\t" kind "\t" $1 "\t" $5
+        }' | sort -t "$TAB" -k2,2 -k3,3 > "${WORK}/report"
+
+cat "${WORK}/report"
+if [ ! -s "${WORK}/report" ]; then
+    exit 0
+fi
+
+if grep -q "^[a-z]*${TAB}cf${TAB}CF_AVAILABLE" "${WORK}/report" ; then
+    echo "CF_AVAILABLE* changed, review the redefinitions at the end of the MJGAvailability block" >&2
+fi
+
+if [ -n "$OUTPUT" ] && grep -q "^[a-z]*${TAB}version${TAB}" "${WORK}/report" ; then
+    for STOCK_HEADER in \
+        "${NEW_SDK}/System/Library/Frameworks/CoreFoundation.framework/Headers/CFAvailability.h" \
+        "${NEW_SDK}/usr/include/CoreFoundation/CFAvailability.h" ; do
+        if [ -f "${STOCK_HEADER}.orig" ]; then
+            STOCK_HEADER="${STOCK_HEADER}.orig"
+        fi
+        if [ -f "$STOCK_HEADER" ]; then
+            break
+        fi
+    done
+    if grep -q "MJGAvailability start" "$STOCK_HEADER" ; then
+        echo "${STOCK_HEADER} is already patched and there is no .orig, cannot regenerate" >&2
+        exit 2
+    fi
+    "${SCRIPT_DIR}/generateHackedHeader.sh" -s "$NEW_SDK" -c "$STOCK_HEADER" -o "$OUTPUT"
+    echo "regenerated ${OUTPUT}" >&2
+fi
+exit 1
@@ -0,0 +1,48 @@
+#!/bin/bash
+#
+# Checks auditWeakImports.sh against the arm64 iOS Mach-O files of this directory: strong.o
+# references StubFunction22 (iOS 9.1) strongly, weak.o references StubFunction21 (iOS 9.0)
+# weakly, libmixed.a holds both, and libuse.dylib links them against libStub.tbd, so its nm
+# lines end with "(from libStub)". Runs on any host with llvm-nm.
+#
+# usage: check.sh [-r]
+#
+# -r rebuilds the Mach-O files first with llvm-mc, llvm-ar and LD (default ld64.lld).
+# NM selects the nm to use (default llvm-nm).
+#
+
+set -e
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+REPO=$(cd "${DIR}/../.." && pwd)
+REBUILD=0
+LD=${LD:-ld64.lld}
+export NM=${NM:-llvm-nm}
+export LC_ALL=C
+
+while getopts "r" OPTION ; do
+    case $OPTION in
+        r) REBUILD=1 ;;
+        *) sed -n '8s/^# //p' "$0" >&2 ; exit 2 ;;
+    esac
+done
+
+cd "$DIR"
+
+if [ $REBUILD -eq 1 ]; then
+    llvm-mc -triple arm64-apple-ios8.0 -filetype=obj strong.s -o strong.o
+    llvm-mc -triple arm64-apple-ios8.0 -filetype=obj weak.s -o weak.o
+    rm -f libmixed.a
+    llvm-ar rcs libmixed.a strong.o weak.o
+    $LD -arch arm64 -platform_version ios 8.0 9.0 -dylib -install_name /usr/lib/libuse.dylib \
+        strong.o weak.o libStub.tbd libSystem.tbd -o libuse.dylib
+fi
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+"${REPO}/makeStubSDK.sh" -n 40 "${WORK}/sdk"
+"${REPO}/auditWeakImports.sh" -s "${WORK}/sdk" -i 8.0 strong.o weak.o libmixed.a libuse.dylib \
+    > "${WORK}/output" || [ $? -eq 1 ]
+diff -u expected.txt "${WORK}/output"
+echo "auditWeakImports.sh: OK"
@@ -0,0 +1,8 @@
+	.section	__TEXT,__text,regular,pure_instructions
+	.globl	_useStrong
+	.p2align	2
+_useStrong:
+	bl	_StubFunction22
+	adrp	x8, _StubConstant23@GOTPAGE
+	bl	_StubFunction2
+	ret
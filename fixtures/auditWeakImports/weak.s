@@ -0,0 +1,7 @@
+	.section	__TEXT,__text,regular,pure_instructions
+	.globl	_useWeak
+	.weak_reference	_StubFunction21
+	.p2align	2
+_useWeak:
+	bl	_StubFunction21
+	ret
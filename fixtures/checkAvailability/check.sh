@@ -0,0 +1,94 @@
+#!/bin/bash
+#
+# Checks the -c cache of checkAvailability.sh against a stub SDK from makeStubSDK.sh: uses.m is
+# compiled by two TUs, with iOS 8.0 and 9.0 deployment targets, and uses StubFunction17 (iOS 8.1)
+# and StubFunction22 (iOS 9.1). A cold and a warm run must report what an uncached run does, and
+# a warm run of either TU alone what that TU reports. In a git repository with an a/util.h and a
+# b/util.h, a TU including "util.h" with -I ../a must only check a/util.h. Runs on any host.
+#
+# usage: check.sh
+#
+
+set -e
+
+REPO=$(cd "$(dirname "$0")/../.." && pwd)
+export LC_ALL=C
+
+if [ $# -ne 0 ]; then
+    sed -n '9s/^# //p' "$0" >&2
+    exit 2
+fi
+
+# Physical, as git rev-parse --show-toplevel prints it (mktemp -d is under a symlink on macOS).
+WORK=$(cd "$(mktemp -d)" && pwd -P)
+trap 'rm -rf "$WORK"' EXIT
+
+# check NAME COMPILE_COMMANDS [OPTION...]
+#   Runs checkAvailability.sh on COMPILE_COMMANDS into WORK/NAME, which must hold findings.
+check() {
+    local NAME=$1
+    local COMMANDS=$2
+    shift 2
+    local STATUS=0
+    "${REPO}/checkAvailability.sh" -p "${WORK}/${COMMANDS}" -s "${WORK}/sdk" -x "${WORK}/index" "$@" \
+        > "${WORK}/${NAME}" 2> /dev/null || STATUS=$?
+    if [ $STATUS -ne 1 ]; then
+        echo "checkAvailability.sh: ${NAME} exited with ${STATUS} instead of 1" >&2
+        return 1
+    fi
+}
+
+# commands FILE VERSION...
+#   Writes a compile_commands.json with a TU of uses.m per iOS deployment target VERSION.
+commands() {
+    local FILE=$1
+    local VERSION
+    local SEPARATOR="["
+    shift
+    for VERSION in "$@" ; do
+        printf '%s\n {"directory": "%s", "file": "uses.m", "command": "clang -miphoneos-version-min=%s -c uses.m"}' \
+            "$SEPARATOR" "$WORK" "$VERSION"
+        SEPARATOR=","
+    done > "${WORK}/${FILE}"
+    echo "]" >> "${WORK}/${FILE}"
+}
+
+"${REPO}/makeStubSDK.sh" -n 40 "${WORK}/sdk"
+"${REPO}/indexAvailability.sh" -s "${WORK}/sdk" -o "${WORK}/index" 2> /dev/null
+printf 'void uses(void) {\n    StubFunction17();\n    StubFunction22();\n}\n' > "${WORK}/uses.m"
+commands both.json 8.0 9.0
+commands ios8.json 8.0
+commands ios9.json 9.0
+
+check expected both.json
+check expected8 ios8.json
+check expected9 ios9.json
+if [ "$(wc -l < "${WORK}/expected8")" -ne 2 ] || [ "$(wc -l < "${WORK}/expected9")" -ne 1 ]; then
+    echo "checkAvailability.sh: unexpected findings without the cache" >&2
+    exit 1
+fi
+
+check cold both.json -c "${WORK}/cache"
+check warm both.json -c "${WORK}/cache"
+check warm8 ios8.json -c "${WORK}/cache"
+check warm9 ios9.json -c "${WORK}/cache"
+diff -u "${WORK}/expected" "${WORK}/cold"
+diff -u "${WORK}/expected" "${WORK}/warm"
+diff -u "${WORK}/expected8" "${WORK}/warm8"
+diff -u "${WORK}/expected9" "${WORK}/warm9"
+
+mkdir -p "${WORK}/project/a" "${WORK}/project/b" "${WORK}/project/src"
+printf 'void a(void) {\n    StubFunction17();\n}\n' > "${WORK}/project/a/util.h"
+printf 'void b(void) {\n    StubFunction22();\n}\n' > "${WORK}/project/b/util.h"
+printf '#include "util.h"\n' > "${WORK}/project/src/main.m"
+printf '[{"directory": "%s", "file": "main.m", "command": "clang -miphoneos-version-min=8.0 -I ../a -c main.m"}]\n' \
+    "${WORK}/project/src" > "${WORK}/project.json"
+git -C "${WORK}/project" init -q
+git -C "${WORK}/project" add .
+(cd "${WORK}/project" && check headers project.json)
+if [ "$(cut -d : -f 1 "${WORK}/headers")" != "${WORK}/project/a/util.h" ]; then
+    echo "checkAvailability.sh: -I ../a didn't resolve util.h to a/util.h alone" >&2
+    cat "${WORK}/headers" >&2
+    exit 1
+fi
+echo "checkAvailability.sh: OK"
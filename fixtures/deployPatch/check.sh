@@ -0,0 +1,115 @@
+#!/bin/bash
+#
+# Checks deployPatch.sh on a fake Xcode with the stock CFAvailability.h in an iPhoneOS SDK (and
+# its unversioned symlink), a MacOSX SDK, and an AppleTVOS SDK whose stock header was updated:
+# patching, running it again, refusing the updated SDK, -v and -r, which must leave a header
+# replaced since it was patched alone. Runs on any host.
+#
+# usage: check.sh
+#
+
+set -e
+
+REPO=$(cd "$(dirname "$0")/../.." && pwd)
+export LC_ALL=C
+
+if [ $# -ne 0 ]; then
+    sed -n '8s/^# //p' "$0" >&2
+    exit 2
+fi
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+XCODE="${WORK}/Xcode"
+HEADER="System/Library/Frameworks/CoreFoundation.framework/Headers/CFAvailability.h"
+IOS="${XCODE}/Platforms/iPhoneOS.platform/Developer/SDKs/iPhoneOS9.1.sdk/${HEADER}"
+MAC="${XCODE}/Platforms/MacOSX.platform/Developer/SDKs/MacOSX10.11.sdk/${HEADER}"
+TVOS="${XCODE}/Platforms/AppleTVOS.platform/Developer/SDKs/AppleTVOS9.0.sdk/${HEADER}"
+
+# deploy STATUS NAME [OPTION...]
+#   Runs deployPatch.sh on the fake Xcode into WORK/NAME, which must exit with STATUS.
+deploy() {
+    local EXPECTED=$1
+    local NAME=$2
+    shift 2
+    local STATUS=0
+    "${REPO}/deployPatch.sh" -x "$XCODE" "$@" > "${WORK}/${NAME}" 2>&1 || STATUS=$?
+    if [ $STATUS -ne "$EXPECTED" ]; then
+        echo "deployPatch.sh: ${NAME} exited with ${STATUS} instead of ${EXPECTED}" >&2
+        cat "${WORK}/${NAME}" >&2
+        return 1
+    fi
+}
+
+# expect NAME LINE
+#   Fails unless the output of the run NAME has LINE.
+expect() {
+    if ! grep -qxF "$2" "${WORK}/$1" ; then
+        echo "deployPatch.sh: ${1} didn't print \"${2}\"" >&2
+        cat "${WORK}/$1" >&2
+        return 1
+    fi
+}
+
+# same FILE EXPECTED
+#   Fails unless FILE has the content of EXPECTED.
+same() {
+    if ! cmp -s "$1" "$2" ; then
+        echo "deployPatch.sh: ${1#"${WORK}/"} isn't $(basename "$2")" >&2
+        return 1
+    fi
+}
+
+for FILE in "$IOS" "$MAC" "$TVOS" ; do
+    mkdir -p "$(dirname "$FILE")"
+    cp "${REPO}/CFAvailability.h" "$FILE"
+done
+ln -s iPhoneOS9.1.sdk "${XCODE}/Platforms/iPhoneOS.platform/Developer/SDKs/iPhoneOS.sdk"
+echo "// Updated" >> "$TVOS"
+cp "$TVOS" "${WORK}/updated.h"
+
+deploy 0 patch -p "iPhoneOS MacOSX"
+expect patch "iPhoneOS9.1.sdk: patched"
+expect patch "MacOSX10.11.sdk: patched"
+if [ "$(grep -c "" "${WORK}/patch")" -ne 2 ]; then
+    echo "deployPatch.sh: the iPhoneOS.sdk symlink was patched apart from iPhoneOS9.1.sdk" >&2
+    exit 1
+fi
+same "$IOS" "${REPO}/CFAvailability-hacked.h"
+same "${IOS}.orig" "${REPO}/CFAvailability.h"
+same "$MAC" "${REPO}/CFAvailability-hacked.h"
+
+deploy 0 again -p "iPhoneOS MacOSX"
+expect again "iPhoneOS9.1.sdk: already patched"
+expect again "MacOSX10.11.sdk: already patched"
+
+deploy 1 refused
+expect refused "iPhoneOS9.1.sdk: already patched"
+same "$TVOS" "${WORK}/updated.h"
+if [ -e "${TVOS}.orig" ]; then
+    echo "deployPatch.sh: the refused AppleTVOS9.0.sdk got a .orig" >&2
+    exit 1
+fi
+
+deploy 0 verify -v -p "iPhoneOS MacOSX"
+expect verify "iPhoneOS9.1.sdk: patched"
+deploy 1 unpatched -v
+expect unpatched "AppleTVOS9.0.sdk: not patched"
+
+# An Xcode update put a new stock header over the hacked one: the .orig is older than it.
+cp "${WORK}/updated.h" "$MAC"
+deploy 1 rollback -r
+expect rollback "iPhoneOS9.1.sdk: restored"
+expect rollback "AppleTVOS9.0.sdk: nothing to roll back"
+same "$IOS" "${REPO}/CFAvailability.h"
+same "$MAC" "${WORK}/updated.h"
+same "${MAC}.orig" "${REPO}/CFAvailability.h"
+if [ -e "${IOS}.orig" ]; then
+    echo "deployPatch.sh: -r left the .orig of iPhoneOS9.1.sdk" >&2
+    exit 1
+fi
+
+deploy 1 restored -v -p iPhoneOS
+expect restored "iPhoneOS9.1.sdk: not patched"
+echo "deployPatch.sh: OK"
@@ -0,0 +1,42 @@
+#!/bin/bash
+#
+# Checks generateHackedHeader.sh against a stub SDK from makeStubSDK.sh, whose Availability.h
+# lists iOS 2.0 - 9.1 and OS X 10.0 - 10.11 like the SDK CFAvailability-hacked.h was written
+# for. The generated header must match the checked-in one, apart from the blank line the stock
+# CFAvailability.h ends with, and -i 8.0 -m 10.9 must leave fewer directives. Runs on any host.
+#
+# usage: check.sh
+#
+
+set -e
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+REPO=$(cd "${DIR}/../.." && pwd)
+export LC_ALL=C
+
+if [ $# -ne 0 ]; then
+    sed -n '8s/^# //p' "$0" >&2
+    exit 2
+fi
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+# directives HEADER
+#   Prints the number of preprocessor directives in HEADER.
+directives() {
+    grep -c '^[[:space:]]*#' "$1"
+}
+
+"${REPO}/makeStubSDK.sh" -n 40 "${WORK}/sdk"
+"${REPO}/generateHackedHeader.sh" -s "${WORK}/sdk" -o "${WORK}/full.h"
+sed '${/^$/d;}' "${WORK}/full.h" | diff -u "${REPO}/CFAvailability-hacked.h" -
+
+"${REPO}/generateHackedHeader.sh" -s "${WORK}/sdk" -i 8.0 -m 10.9 -o "${WORK}/trimmed.h"
+FULL=$(directives "${WORK}/full.h")
+TRIMMED=$(directives "${WORK}/trimmed.h")
+if [ "$TRIMMED" -ge "$FULL" ]; then
+    echo "generateHackedHeader.sh: -i 8.0 -m 10.9 left ${TRIMMED} of ${FULL} directives" >&2
+    exit 1
+fi
+echo "generateHackedHeader.sh: OK (${FULL} directives, ${TRIMMED} with -i 8.0 -m 10.9)"
@@ -0,0 +1,206 @@
+#!/bin/bash
+#
+# Writes MJGAvailabilityTable.hpp, a C++17 constexpr copy of an SDK's version table with
+# template checks against the soft max, for C++ TUs that shouldn't pay for Availability.h.
+#
+# usage: generateAvailabilityTable.sh [-s SDK] [-a Availability.h] [-o OUTPUT]
+#
+
+set -e
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+. "${SCRIPT_DIR}/availabilityCommon.sh"
+
+SDK=""
+AVAILABILITY_HEADERS=""
+OUTPUT=""
+
+while getopts "s:a:o:" OPTION ; do
+    case $OPTION in
+        s) SDK=$OPTARG ;;
+        a) AVAILABILITY_HEADERS="$AVAILABILITY_HEADERS $OPTARG" ;;
+        o) OUTPUT=$OPTARG ;;
+        *) sed -n '6s/^# //p' "$0" >&2 ; exit 1 ;;
+    esac
+done
+
+if [ -z "$AVAILABILITY_HEADERS" ]; then
+    if [ -z "$SDK" ]; then
+        SDK=$(xcrun --sdk iphoneos --show-sdk-path)
+    fi
+    AVAILABILITY_HEADERS=$(availability_headers "$SDK")
+fi
+if [ -z "$AVAILABILITY_HEADERS" ]; then
+    echo "No Availability.h found in ${SDK}" >&2
+    exit 1
+fi
+
+# emit_versions PLATFORM NAMESPACE
+emit_versions() {
+    local TABLE
+    TABLE=$(availability_versions "$1" $AVAILABILITY_HEADERS)
+    if [ -z "$TABLE" ]; then
+        echo "No __${1}_x_y versions found in${AVAILABILITY_HEADERS}" >&2
+        exit 1
+    fi
+    echo "namespace $2 {"
+    while read -r NAME VALUE ; do
+        echo "inline constexpr Version v${NAME} = ${VALUE};"
+    done <<< "$TABLE"
+    echo "inline constexpr Version all[] = {"
+    while read -r NAME VALUE ; do
+        echo "    v${NAME},"
+    done <<< "$TABLE"
+    echo "};"
+    echo "} // namespace $2"
+}
+
+# emit_constants PLATFORM
+#   The __IPHONE_x_y / __MAC_x_y constants of Availability.h, for soft max values spelled
+#   -D__IPHONE_OS_VERSION_SOFT_MAX_REQUIRED=__IPHONE_8_0. Same tokens as Availability.h, so that
+#   including it afterwards doesn't redefine them differently.
+emit_constants() {
+    local TABLE
+    TABLE=$(availability_versions "$1" $AVAILABILITY_HEADERS)
+    while read -r NAME VALUE ; do
+        echo "#ifndef __${1}_${NAME}"
+        echo "#define __${1}_${NAME} ${VALUE}"
+        echo "#endif"
+    done <<< "$TABLE"
+}
+
+# emit_requirements PLATFORM NAMESPACE ENUM LABEL
+#   One deprecated require<> specialization per version above the soft max, so that the warning
+#   names the platform and version like the hack does.
+emit_requirements() {
+    local TABLE
+    TABLE=$(availability_versions "$1" $AVAILABILITY_HEADERS)
+    while read -r NAME VALUE ; do
+        echo "#if MJG_AVAILABILITY_${1}_SOFT_MAX != 0 && MJG_AVAILABILITY_${1}_SOFT_MAX < ${VALUE}"
+        echo "template <>"
+        echo "[[gnu::always_inline, deprecated(\"API only available from ${4} ${NAME//_/.}, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage\")]]"
+        echo "constexpr void require<Platform::${3}, ${2}::v${NAME}>() noexcept {}"
+        echo "#endif"
+    done <<< "$TABLE"
+}
+
+emit_table() {
+    cat << 'EOF'
+//
+//  MJGAvailabilityTable.hpp
+//
+//  Generated by generateAvailabilityTable.sh, do not edit.
+//
+//  The iOS / OS X version table as C++17 constants, checked against the soft max in templates
+//  instead of through the __IPHONE_##_ios / __MAC_##_mac macro chain. Doesn't include
+//  Availability.h; the soft max comes from -D__IPHONE_OS_VERSION_SOFT_MAX_REQUIRED=<value>
+//  (resp. __MAC_OS_X_VERSION_SOFT_MAX_REQUIRED), e.g. 80000 or __IPHONE_8_0, else from the
+//  deployment target clang predefines.
+//
+//  Example usage:
+//
+//    using namespace mjg::availability;
+//
+//    require<Platform::iOS, ios::v9_0>();         // too new: deprecation warning, like the hack
+//    require_strict<Platform::iOS, ios::v9_0>();  // too new: compile error
+//    if constexpr (is_available<Platform::iOS, ios::v9_0>) { ... }
+//
+
+#ifndef MJG_AVAILABILITY_TABLE_HPP
+#define MJG_AVAILABILITY_TABLE_HPP
+
+namespace mjg {
+namespace availability {
+
+enum class Platform { iOS, OSX };
+
+// Packed as in Availability.h: 80000 for iOS 8.0, 1090 for OS X 10.9, 101000 for OS X 10.10.
+using Version = unsigned long;
+
+EOF
+    emit_versions IPHONE ios
+    echo
+    emit_versions MAC osx
+    cat << 'EOF'
+
+// The soft max may be spelled with the constants of Availability.h, which isn't included.
+EOF
+    emit_constants IPHONE
+    emit_constants MAC
+    cat << 'EOF'
+
+#if defined(__IPHONE_OS_VERSION_SOFT_MAX_REQUIRED)
+#define MJG_AVAILABILITY_IPHONE_SOFT_MAX __IPHONE_OS_VERSION_SOFT_MAX_REQUIRED
+#elif defined(__ENVIRONMENT_IPHONE_OS_VERSION_MIN_REQUIRED__)
+#define MJG_AVAILABILITY_IPHONE_SOFT_MAX __ENVIRONMENT_IPHONE_OS_VERSION_MIN_REQUIRED__
+#else
+#define MJG_AVAILABILITY_IPHONE_SOFT_MAX 0 // not targeting iOS, nothing is too new
+#endif
+
+#if defined(__MAC_OS_X_VERSION_SOFT_MAX_REQUIRED)
+#define MJG_AVAILABILITY_MAC_SOFT_MAX __MAC_OS_X_VERSION_SOFT_MAX_REQUIRED
+#elif defined(__ENVIRONMENT_MAC_OS_X_VERSION_MIN_REQUIRED__)
+#define MJG_AVAILABILITY_MAC_SOFT_MAX __ENVIRONMENT_MAC_OS_X_VERSION_MIN_REQUIRED__
+#else
+#define MJG_AVAILABILITY_MAC_SOFT_MAX 0
+#endif
+
+inline constexpr Version ios_soft_max = MJG_AVAILABILITY_IPHONE_SOFT_MAX;
+inline constexpr Version osx_soft_max = MJG_AVAILABILITY_MAC_SOFT_MAX;
+
+constexpr Version soft_max(Platform platform) {
+    return platform == Platform::iOS ? ios_soft_max : osx_soft_max;
+}
+
+template <class Table>
+constexpr bool contains(const Table &table, Version version) {
+    for (Version known : table) {
+        if (known == version) {
+            return true;
+        }
+    }
+    return false;
+}
+
+constexpr bool known(Platform platform, Version version) {
+    return platform == Platform::iOS ? contains(ios::all, version) : contains(osx::all, version);
+}
+
+constexpr bool too_new(Platform platform, Version version) {
+    return soft_max(platform) != 0 && version > soft_max(platform);
+}
+
+template <Platform P, Version V>
+struct checked {
+    static_assert(known(P, V), "Unknown version, regenerate MJGAvailabilityTable.hpp");
+    static constexpr bool available = !too_new(P, V);
+};
+
+template <Platform P, Version V>
+inline constexpr bool is_available = checked<P, V>::available;
+
+// always_inline so that even -O0 builds don't emit a call. The versions above the soft max
+// are deprecated specializations, below.
+template <Platform P, Version V>
+[[gnu::always_inline]] constexpr void require() noexcept {
+    static_assert(known(P, V), "Unknown version, regenerate MJGAvailabilityTable.hpp");
+}
+
+template <Platform P, Version V>
+[[gnu::always_inline]] constexpr void require_strict() noexcept {
+    static_assert(is_available<P, V>, "API only available after the soft max");
+}
+
+EOF
+    emit_requirements IPHONE ios iOS iOS
+    emit_requirements MAC osx OSX "OS X"
+    cat << 'EOF'
+
+} // namespace availability
+} // namespace mjg
+
+#endif
+EOF
+}
+
+emit_table > "${OUTPUT:-/dev/stdout}"
@@ -0,0 +1,205 @@
+#!/bin/bash
+#
+# Writes CFAvailability-hacked.h from the version table of an SDK's Availability.h.
+#
+# usage: generateHackedHeader.sh [-s SDK] [-a Availability.h] [-c CFAvailability.h]
+#                                [-i IOS_DEPLOYMENT_TARGET] [-m MAC_DEPLOYMENT_TARGET] [-o OUTPUT]
+#
+# -i / -m leave out every block at or below the given deployment target: the soft max
+# can never be lower than the deployment target, so those blocks never fire.
+#
+
+set -e
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+. "${SCRIPT_DIR}/availabilityCommon.sh"
+
+SDK=""
+AVAILABILITY_HEADERS=""
+STOCK_HEADER="${SCRIPT_DIR}/CFAvailability.h"
+IOS_TARGET=""
+MAC_TARGET=""
+OUTPUT=""
+
+while getopts "s:a:c:i:m:o:" OPTION ; do
+    case $OPTION in
+        s) SDK=$OPTARG ;;
+        a) AVAILABILITY_HEADERS="$AVAILABILITY_HEADERS $OPTARG" ;;
+        c) STOCK_HEADER=$OPTARG ;;
+        i) IOS_TARGET=$OPTARG ;;
+        m) MAC_TARGET=$OPTARG ;;
+        o) OUTPUT=$OPTARG ;;
+        *) sed -n '5,6s/^# //p' "$0" >&2 ; exit 1 ;;
+    esac
+done
+
+if [ -z "$AVAILABILITY_HEADERS" ]; then
+    if [ -z "$SDK" ]; then
+        SDK=$(xcrun --sdk iphoneos --show-sdk-path)
+    fi
+    AVAILABILITY_HEADERS=$(availability_headers "$SDK")
+fi
+if [ -z "$AVAILABILITY_HEADERS" ]; then
+    echo "No Availability.h found in ${SDK}" >&2
+    exit 1
+fi
+
+# emit_blocks PLATFORM SOFT_MAX_MACRO DISPLAY_NAME DEPLOYMENT_TARGET
+emit_blocks() {
+    local PLATFORM=$1
+    local SOFT_MAX=$2
+    local DISPLAY=$3
+    local TABLE
+    local FLOOR=0
+    TABLE=$(availability_versions "$PLATFORM" $AVAILABILITY_HEADERS)
+    if [ -z "$TABLE" ]; then
+        echo "No __${PLATFORM}_x_y versions found in${AVAILABILITY_HEADERS}" >&2
+        exit 1
+    fi
+    if [ -n "$4" ]; then
+        if ! FLOOR=$(availability_version_value "$4" "$TABLE"); then
+            echo "Unknown ${DISPLAY} deployment target $4" >&2
+            exit 1
+        fi
+    fi
+    while read -r NAME VALUE ; do
+        if [ "$VALUE" -le "$FLOOR" ]; then
+            continue
+        fi
+        cat << EOF
+#if ${SOFT_MAX} < __${PLATFORM}_${NAME}
+#undef __AVAILABILITY_INTERNAL__${PLATFORM}_${NAME}
+#define __AVAILABILITY_INTERNAL__${PLATFORM}_${NAME} __AVAILABILITY_TOO_NEW("API only available from ${DISPLAY} ${NAME//_/.}, use API_AVAILABILITY_START_IGNORE_TOO_NEW macro to validate this API usage")
+#endif
+
+EOF
+    done <<< "$TABLE"
+}
+
+emit_mjg_block() {
+    cat << 'EOF'
+//
+//  MJGAvailability start
+//
+//  Created by Matt Galloway on 18/01/2012.
+//  Copyright 2012 Matt Galloway. All rights reserved.
+//
+
+/**
+* Example usage:
+*   If you want to see if you're using methods that are only defined in iOS 4.0 and lower
+*   then you would use the following. Replace the __IPHONE_4_0 with whatever other macro
+*   you require. See Availability.h for iOS versions these relate to.
+*
+* YourProjectPrefixHeader.pch:
+*   #define __IPHONE_OS_VERSION_SOFT_MAX_REQUIRED __IPHONE_4_0
+*   #import "MJGAvailability.h"
+*
+*   // The rest of your prefix header as normal
+*   #import <UIKit/UIKit.h>
+*
+* For OSX, you also get the warnings:
+*
+* YourOSXPrefixHeader.pch
+*   #define __MAC_OS_X_VERSION_SOFT_MAX_REQUIRED __MAC_10_7
+*   #import "MJGAvailability.h"
+*
+* If you want to suppress a single warning (i.e. because you know that what you're doing is
+* actually OK) then you can do something like this:
+*
+*   UINavigationBar *navBar = self.navigationController.navigationBar;
+*   if ([navBar respondsToSelector:@selector(setBackgroundImage:forBarMetrics:)]) {
+*   #pragma clang diagnostic push
+*   #pragma clang diagnostic ignored "-Wdeprecated-declarations"
+*       [navBar setBackgroundImage:[UIImage imageNamed:@"navbar_bg.png"] forBarMetrics:UIBarMetricsDefault];
+*   #pragma clang diagnostic pop
+*   }
+*
+* Or you can use the handy macros defined in this file also, like this:
+*
+*   UINavigationBar *navBar = self.navigationController.navigationBar;
+*   if ([navBar respondsToSelector:@selector(setBackgroundImage:forBarMetrics:)]) {
+*   API_AVAILABILITY_START_IGNORE_TOO_NEW
+*       [navBar setBackgroundImage:[UIImage imageNamed:@"navbar_bg.png"] forBarMetrics:UIBarMetricsDefault];
+*   MJG_END_IGNORE_TOO_NEW
+*   }
+*
+*/
+
+#import <Availability.h>
+
+#define __AVAILABILITY_TOO_NEW(x) __attribute__((deprecated(x))) __attribute__((weak_import))
+
+#if defined(__IPHONE_OS_VERSION_MIN_REQUIRED)
+
+#ifndef __IPHONE_OS_VERSION_SOFT_MAX_REQUIRED
+#define __IPHONE_OS_VERSION_SOFT_MAX_REQUIRED __IPHONE_OS_VERSION_MIN_REQUIRED
+#endif
+
+#if __IPHONE_OS_VERSION_SOFT_MAX_REQUIRED < __IPHONE_OS_VERSION_MIN_REQUIRED
+#error You cannot ask for a soft max version which is less than the deployment target
+#endif
+
+EOF
+    emit_blocks IPHONE __IPHONE_OS_VERSION_SOFT_MAX_REQUIRED iOS "$IOS_TARGET"
+    cat << 'EOF'
+#endif // end of #if defined(__IPHONE_OS_VERSION_MIN_REQUIRED)
+
+#if defined(__MAC_OS_X_VERSION_MIN_REQUIRED)
+
+#ifndef __MAC_OS_X_VERSION_SOFT_MAX_REQUIRED
+#define __MAC_OS_X_VERSION_SOFT_MAX_REQUIRED __MAC_OS_X_VERSION_MIN_REQUIRED
+#endif
+
+#if __MAC_OS_X_VERSION_SOFT_MAX_REQUIRED < __MAC_OS_X_VERSION_MIN_REQUIRED
+#error You cannot ask for a soft max version which is less than the deployment target
+#endif
+
+EOF
+    emit_blocks MAC __MAC_OS_X_VERSION_SOFT_MAX_REQUIRED "OS X" "$MAC_TARGET"
+    cat << 'EOF'
+#endif // end of #if defined(__MAC_OS_X_VERSION_MIN_REQUIRED)
+
+// next redefinitions required since SDK 7
+// Every CF_ availability macro goes through __OSX_AVAILABLE_STARTING, i.e. through the
+// __AVAILABILITY_INTERNAL__ macros redefined above. CF_ENUM_* expand to these, and
+// CF_EXTENSION_UNAVAILABLE* carry no version. CF_DEPRECATED* keep their stock attribute,
+// deprecation message included, after that check.
+#undef CF_AVAILABLE
+#define CF_AVAILABLE(_mac, _ios) __OSX_AVAILABLE_STARTING(__MAC_##_mac, __IPHONE_##_ios)
+#undef CF_AVAILABLE_MAC
+#define CF_AVAILABLE_MAC(_mac) __OSX_AVAILABLE_STARTING(__MAC_##_mac, __IPHONE_NA)
+#undef CF_AVAILABLE_IOS
+#define CF_AVAILABLE_IOS(_ios) __OSX_AVAILABLE_STARTING(__MAC_NA, __IPHONE_##_ios)
+#undef CF_DEPRECATED
+#define CF_DEPRECATED(_macIntro, _macDep, _iosIntro, _iosDep, ...) CF_AVAILABLE(_macIntro, _iosIntro) __attribute__((availability(ios,introduced=_iosIntro,deprecated=_iosDep,message="" __VA_ARGS__)))
+#undef CF_DEPRECATED_MAC
+#define CF_DEPRECATED_MAC(_macIntro, _macDep, ...) CF_AVAILABLE_MAC(_macIntro) __attribute__((availability(ios,unavailable)))
+#undef CF_DEPRECATED_IOS
+#define CF_DEPRECATED_IOS(_iosIntro, _iosDep, ...) CF_AVAILABLE_IOS(_iosIntro) __attribute__((availability(ios,introduced=_iosIntro,deprecated=_iosDep,message="" __VA_ARGS__)))
+
+//
+//  MJGAvailability end
+//
+
+EOF
+}
+
+MJG_BLOCK=$(mktemp)
+trap 'rm -f "$MJG_BLOCK"' EXIT
+emit_mjg_block > "$MJG_BLOCK"
+
+# The hack goes at the end of the iOS section of the stock header, right before its #endif.
+awk -v block="$MJG_BLOCK" '
+    /This section is for compilers targeting iOS/ { in_ios = 1 }
+    in_ios && $0 == "#endif" {
+        while ((getline line < block) > 0)
+            print line
+        in_ios = 0
+        spliced = 1
+    }
+    { print }
+    END { if (!spliced) exit 1 }' "$STOCK_HEADER" > "${OUTPUT:-/dev/stdout}" || {
+    echo "Could not find the iOS section of ${STOCK_HEADER}" >&2
+    exit 1
+}
@@ -0,0 +1,81 @@
+#!/bin/bash
+#
+# Scans an SDK header tree once and writes its availability index: one sorted
+# "<symbol>\t<PLATFORM>\t<introduced>\t<deprecated>\t<unavailable>" row per symbol and platform,
+# with versions packed as in Availability.h (80000 for iOS 8.0). Checkers look symbols up with
+# join or a binary search without parsing any header; -q does the latter.
+#
+# usage: indexAvailability.sh [-s SDK] [-j JOBS] -o INDEX
+#        indexAvailability.sh -o INDEX -q SYMBOL...
+#
+
+set -e
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+. "${SCRIPT_DIR}/availabilityCommon.sh"
+
+SDK=""
+INDEX=""
+JOBS=$(getconf _NPROCESSORS_ONLN)
+QUERY=0
+
+while getopts "s:j:o:q" OPTION ; do
+    case $OPTION in
+        s) SDK=$OPTARG ;;
+        j) JOBS=$OPTARG ;;
+        o) INDEX=$OPTARG ;;
+        q) QUERY=1 ;;
+        *) sed -n '8,9s/^# //p' "$0" >&2 ; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [ -z "$INDEX" ]; then
+    sed -n '8,9s/^# //p' "$0" >&2
+    exit 1
+fi
+
+# A binary search of the sorted index per symbol, so that a lookup reads a few blocks rather than
+# the whole index as join would. look does the same, but only util-linux's takes -b.
+if [ $QUERY -eq 1 ]; then
+    perl -e '
+        open(INDEX, "<", shift) or die "$!\n";
+        # Moves to the first row starting at or after offset $_[0].
+        sub start {
+            seek(INDEX, $_[0] > 0 ? $_[0] - 1 : 0, 0);
+            <INDEX> if $_[0] > 0;
+        }
+        # The symbol of that row.
+        sub row {
+            start($_[0]);
+            my $line = <INDEX>;
+            return defined($line) ? (split(/\t/, $line))[0] : undef;
+        }
+        my %seen;
+        for my $symbol (sort grep { !$seen{$_}++ } @ARGV) {
+            my ($low, $high) = (0, -s INDEX);
+            while ($low < $high) {
+                my $middle = int(($low + $high) / 2);
+                my $found = row($middle);
+                if (defined($found) && $found lt $symbol) {
+                    $low = $middle + 1;
+                } else {
+                    $high = $middle;
+                }
+            }
+            start($low);
+            while (my $line = <INDEX>) {
+                last if (split(/\t/, $line))[0] ne $symbol;
+                print $line;
+            }
+        }' "$INDEX" "$@"
+    exit 0
+fi
+
+if [ -z "$SDK" ]; then
+    SDK=$(xcrun --sdk iphoneos --show-sdk-path)
+fi
+
+availability_index "$SDK" "$JOBS" > "${INDEX}.$$"
+mv -f "${INDEX}.$$" "$INDEX"
+echo "$(($(wc -l < "$INDEX") - 1)) entries, $(wc -c < "$INDEX" | tr -d ' ') bytes" >&2
@@ -0,0 +1,127 @@
+#!/bin/bash
+#
+# Builds a stub iOS SDK tree that compiles on any host: Availability.h, TargetConditionals.h,
+# CoreFoundation/CFAvailability.h and a Stub framework header full of declarations using
+# CF_AVAILABLE* and __AVAILABILITY_INTERNAL__IPHONE_x_y, plus a few using CF_DEPRECATED* and
+# __OSX_AVAILABLE_BUT_DEPRECATED.
+#
+# usage: makeStubSDK.sh [-n DECLARATIONS] [-c CFAvailability.h] SDK_DIR
+#
+# Compile against it with -isysroot SDK_DIR (or -isystem SDK_DIR/usr/include) and
+# -D__ENVIRONMENT_IPHONE_OS_VERSION_MIN_REQUIRED__=<value>.
+#
+
+set -e
+
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+
+DECLARATIONS=1000
+CF_HEADER="${SCRIPT_DIR}/CFAvailability.h"
+
+while getopts "n:c:" OPTION ; do
+    case $OPTION in
+        n) DECLARATIONS=$OPTARG ;;
+        c) CF_HEADER=$OPTARG ;;
+        *) sed -n '8s/^# //p' "$0" >&2 ; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [ $# -ne 1 ]; then
+    sed -n '8s/^# //p' "$0" >&2
+    exit 1
+fi
+
+INCLUDE="$1/usr/include"
+IOS_VERSIONS="2_0 2_1 2_2 3_0 3_1 3_2 4_0 4_1 4_2 4_3 5_0 5_1 6_0 6_1 7_0 7_1 8_0 8_1 8_2 8_3 8_4 9_0 9_1"
+MAC_VERSIONS="10_0 10_1 10_2 10_3 10_4 10_5 10_6 10_7 10_8 10_9 10_10 10_11"
+
+mkdir -p "${INCLUDE}/CoreFoundation" "${INCLUDE}/Stub"
+
+cat > "${INCLUDE}/TargetConditionals.h" << 'HEADER'
+#ifndef __TARGETCONDITIONALS__
+#define __TARGETCONDITIONALS__
+#define TARGET_OS_MAC 1
+#define TARGET_OS_IPHONE 1
+#define TARGET_OS_EMBEDDED 1
+#define TARGET_OS_WIN32 0
+// Other compilers take clang's branch of CFAvailability.h, with the availability attribute dropped
+#ifndef __clang__
+#define __has_feature(x) 1
+#define availability(...) unused
+#endif
+#endif
+HEADER
+
+: > "${INCLUDE}/AvailabilityMacros.h"
+
+{
+    echo "#ifndef __AVAILABILITY__"
+    echo "#define __AVAILABILITY__"
+    for VERSION in $IOS_VERSIONS ; do
+        echo "#define __IPHONE_${VERSION} $(( ${VERSION%_*} * 10000 + ${VERSION#*_} * 100 ))"
+    done
+    echo "#define __IPHONE_NA 99999"
+    for VERSION in $MAC_VERSIONS ; do
+        MINOR=${VERSION#*_}
+        if [ "$MINOR" -lt 10 ]; then
+            echo "#define __MAC_${VERSION} 10${MINOR}0"
+        else
+            echo "#define __MAC_${VERSION} 10${MINOR}00"
+        fi
+    done
+    echo "#define __MAC_NA 9999"
+    echo "#ifdef __ENVIRONMENT_IPHONE_OS_VERSION_MIN_REQUIRED__"
+    echo "#define __IPHONE_OS_VERSION_MIN_REQUIRED __ENVIRONMENT_IPHONE_OS_VERSION_MIN_REQUIRED__"
+    echo "#endif"
+    echo "#define __AVAILABILITY_INTERNAL_DEPRECATED __attribute__((deprecated))"
+    for VERSION in $IOS_VERSIONS NA ; do
+        echo "#define __AVAILABILITY_INTERNAL__IPHONE_${VERSION} __attribute__((visibility(\"default\")))"
+    done
+    for VERSION in $MAC_VERSIONS NA ; do
+        echo "#define __AVAILABILITY_INTERNAL__MAC_${VERSION} __attribute__((visibility(\"default\")))"
+    done
+    echo "#define __OSX_AVAILABLE_STARTING(_mac, _ios) __AVAILABILITY_INTERNAL##_ios"
+    # Deprecated APIs expand to their own _DEP__ macros, not to those of the introduction version.
+    DEPRECATED_VERSIONS=$IOS_VERSIONS
+    for INTRODUCED in $IOS_VERSIONS ; do
+        echo "#define __AVAILABILITY_INTERNAL__IPHONE_${INTRODUCED}_DEP__IPHONE_NA __attribute__((availability(ios,introduced=${INTRODUCED/_/.})))"
+        for DEPRECATED in $DEPRECATED_VERSIONS ; do
+            echo "#define __AVAILABILITY_INTERNAL__IPHONE_${INTRODUCED}_DEP__IPHONE_${DEPRECATED} __attribute__((availability(ios,introduced=${INTRODUCED/_/.},deprecated=${DEPRECATED/_/.})))"
+        done
+        DEPRECATED_VERSIONS=${DEPRECATED_VERSIONS#* }
+    done
+    echo "#define __AVAILABILITY_INTERNAL__IPHONE_NA_DEP__IPHONE_NA __attribute__((availability(ios,unavailable)))"
+    echo "#define __OSX_AVAILABLE_BUT_DEPRECATED(_macIntro, _macDep, _iosIntro, _iosDep) __AVAILABILITY_INTERNAL##_iosIntro##_DEP##_iosDep"
+    echo "#define __OS_EXTENSION_UNAVAILABLE(_msg)"
+    echo "#define __OSX_EXTENSION_UNAVAILABLE(_msg)"
+    echo "#define __IOS_EXTENSION_UNAVAILABLE(_msg)"
+    echo "#endif"
+} > "${INCLUDE}/Availability.h"
+
+cp "$CF_HEADER" "${INCLUDE}/CoreFoundation/CFAvailability.h"
+
+# Declarations cycle through the iOS versions and the macro spellings found in real SDK headers.
+awk -v count="$DECLARATIONS" -v versions="$IOS_VERSIONS" '
+    BEGIN {
+        n = split(versions, version, " ")
+        print "#include <CoreFoundation/CFAvailability.h>"
+        print ""
+        for (i = 0; i < count; i++) {
+            v = version[i % n + 1]
+            if (i % 4 == 0)
+                printf "void StubFunction%d(void) CF_AVAILABLE(10_9, %s);\n", i, v
+            else if (i % 4 == 1)
+                printf "void StubFunction%d(void) CF_AVAILABLE_IOS(%s);\n", i, v
+            else if (i % 4 == 2)
+                printf "void StubFunction%d(void) __OSX_AVAILABLE_STARTING(__MAC_10_9, __IPHONE_%s);\n", i, v
+            else
+                printf "extern int StubConstant%d __AVAILABILITY_INTERNAL__IPHONE_%s;\n", i, v
+        }
+        # One deprecated API per version and spelling, deprecated in the last version.
+        for (i = 1; i <= n; i++) {
+            printf "void StubDeprecated%d(void) CF_DEPRECATED(10_9, 10_10, %s, %s, \"Use StubFunction instead\");\n", i, version[i], version[n]
+            printf "void StubIOSDeprecated%d(void) CF_DEPRECATED_IOS(%s, %s, \"Use StubFunction instead\");\n", i, version[i], version[n]
+            printf "void StubDeprecatedMacro%d(void) __OSX_AVAILABLE_BUT_DEPRECATED(__MAC_10_9, __MAC_10_10, __IPHONE_%s, __IPHONE_%s);\n", i, version[i], version[n]
+        }
+    }' > "${INCLUDE}/Stub/Stub.h"
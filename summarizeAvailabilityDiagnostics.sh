@@ -0,0 +1,113 @@
+#!/bin/bash
+#
+# Reads compiler output (or clang --serialize-diagnostics .dia files) as a stream, keeps the
+# MJGAvailability "API only available from ..." diagnostics, dedups them by API, version and
+# call site, and writes a per-API summary and optionally SARIF.
+#
+# usage: summarizeAvailabilityDiagnostics.sh [-u] [-o SARIF_FILE] [FILE...]
+#
+# Reads standard input without FILE, e.g. xcodebuild ... 2>&1 | summarizeAvailabilityDiagnostics.sh -u
+# -u also prints each diagnostic the first time it is seen, as the build goes.
+# .dia files are decoded with c-index-test -read-diagnostics.
+#
+
+set -e
+
+UNIQUE=0
+SARIF=""
+
+while getopts "uo:" OPTION ; do
+    case $OPTION in
+        u) UNIQUE=1 ;;
+        o) SARIF=$OPTARG ;;
+        *) sed -n '7s/^# //p' "$0" >&2 ; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+# Every input as plain text diagnostics, in order.
+read_inputs() {
+    local FILE
+    if [ $# -eq 0 ]; then
+        cat
+        return
+    fi
+    for FILE in "$@" ; do
+        case $FILE in
+            *.dia) c-index-test -read-diagnostics "$FILE" 2>&1 ;;
+            *) cat "$FILE" ;;
+        esac
+    done
+}
+
+read_inputs "$@" | awk -v unique="$UNIQUE" -v sarif="$SARIF" '
+    function json(s) {
+        gsub(/\\/, "\\\\", s)
+        gsub(/"/, "\\\"", s)
+        gsub(/\t/, "\\t", s)
+        return "\"" s "\""
+    }
+
+    index($0, "API only available from ") &&
+    match($0, /:[0-9]+:[0-9]+: (warning|error): .* API only available from (iOS|OS X) [0-9.]+/) {
+        file = substr($0, 1, RSTART - 1)
+        rest = substr($0, RSTART + 1)
+        split(rest, field, ":")
+        line = field[1]
+        column = field[2]
+        level = field[3]
+        sub(/^ /, "", level)
+        version = substr($0, RSTART, RLENGTH)
+        sub(/.* API only available from /, "", version)
+        # The API is in ASCII quotes, or in ‘ and ’ when clang runs in a UTF-8 locale.
+        if (!match(rest, /\047|\342\200\230/))
+            next
+        api = substr(rest, RSTART + RLENGTH)
+        if (match(api, /\047|\342\200\231/))
+            api = substr(api, 1, RSTART - 1)
+
+        key = api SUBSEP version SUBSEP file SUBSEP line SUBSEP column
+        if (key in seen)
+            next
+        seen[key] = 1
+
+        if (!((api, version) in uses)) {
+            apis[++count] = api SUBSEP version
+            uses[api, version] = 0
+        }
+        uses[api, version]++
+        if (!((api, version, file) in in_file)) {
+            in_file[api, version, file] = 1
+            files[api, version]++
+        }
+
+        if (sarif != "") {
+            message = $0
+            sub(/^.*: (warning|error): /, "", message)
+            sub(/ \[-W[^]]*\]$/, "", message)
+            results[++result_count] = sprintf("{\"ruleId\":\"too-new-api\",\"level\":%s,\"message\":{\"text\":%s},\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":%s},\"region\":{\"startLine\":%d,\"startColumn\":%d}}}]}",
+                json(level), json(message), json(file), line, column)
+        }
+        if (unique) {
+            print
+            fflush()
+        }
+    }
+
+    END {
+        if (unique && count)
+            print ""
+        printf "%-50s %-12s %8s %8s\n", "API", "available", "uses", "files"
+        for (i = 1; i <= count; i++) {
+            split(apis[i], part, SUBSEP)
+            printf "%-50s %-12s %8d %8d\n", part[1], part[2], uses[apis[i]], files[apis[i]] | "sort -k3,3nr -k1,1"
+        }
+        close("sort -k3,3nr -k1,1")
+
+        if (sarif != "") {
+            printf "{\"version\":\"2.1.0\",\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\",\"runs\":[{\"tool\":{\"driver\":{\"name\":\"MJGAvailability\",\"rules\":[{\"id\":\"too-new-api\",\"shortDescription\":{\"text\":\"API newer than the soft max deployment target\"}}]}},\"results\":[" > sarif
+            for (i = 1; i <= result_count; i++)
+                printf "%s%s\n", (i > 1 ? "," : ""), results[i] > sarif
+            print "]}]}" > sarif
+        }
+    }'
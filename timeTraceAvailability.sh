@@ -0,0 +1,182 @@
+#!/bin/bash
+#
+# Attributes clang -ftime-trace time to the availability headers (Availability.h and its
+# AvailabilityInternal.h / AvailabilityMacros.h / AvailabilityVersions.h, CFAvailability.h and
+# MJGAvailability.h), per TU and for the whole build, and optionally writes folded stacks for
+# flamegraph.pl or speedscope.
+#
+# usage: timeTraceAvailability.sh [-j JOBS] [-n TOP_TUS] [-o FOLDED_FILE] [-S] TRACE_OR_DIRECTORY...
+#
+# Directories are searched for *.json traces, e.g. the build's object directory when compiling
+# with -ftime-trace; JSON files without clang's ExecuteCompiler event are skipped. Traces are
+# read in parallel. -S parses them with jq --stream, one event at a time, for traces too big to
+# load: memory stays flat but parsing is about 10 times slower. Shares are of the compile time,
+# the ExecuteCompiler events.
+# "preprocessing" is the time spent inside the header itself, its nested includes excluded;
+# "sema" is the part of it spent on parse / Sema events located in the header.
+#
+
+set -e
+
+JOBS=$(getconf _NPROCESSORS_ONLN)
+TOP=20
+FOLDED=""
+STREAM=""
+WORKER=0
+
+while getopts "j:n:o:SW" OPTION ; do
+    case $OPTION in
+        j) JOBS=$OPTARG ;;
+        n) TOP=$OPTARG ;;
+        o) FOLDED=$OPTARG ;;
+        S) STREAM=-S ;;
+        W) WORKER=1 ;;
+        *) sed -n '8s/^# //p' "$0" >&2 ; exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+# A batch of traces: prints "T\t<tu>\t<total us>" per TU,
+# "R\t<tu>\t<total us>\t<header>\t<preprocessing us>\t<sema us>" per availability header seen by
+# the TU, and "F\t<folded stack>\t<self us>" per include stack.
+if [ $WORKER -eq 1 ]; then
+    EVENTS='select(.ph == "X" and (.name | startswith("Total ") | not)) | [.name, .ts, .dur, (.args.detail // "")] | @tsv'
+    for TRACE in "$@" ; do
+        if [ -n "$STREAM" ]; then
+            jq -rn --stream "fromstream(2 | truncate_stream(inputs | select(.[0][0] == \"traceEvents\"))) | ${EVENTS}" "$TRACE"
+        else
+            jq -r "if type == \"object\" then .traceEvents[]? | ${EVENTS} else empty end" "$TRACE"
+        fi | \
+            LC_ALL=C sort -t "$(printf '\t')" -k2,2n -k3,3nr | \
+            awk -F '\t' -v tu="${TRACE%.json}" '
+                function base(path) {
+                    sub(/:[0-9]+(:[0-9]+)?$/, "", path)
+                    sub(/.*\//, "", path)
+                    return path
+                }
+
+                function availability(header) {
+                    return header ~ /^(Availability|AvailabilityInternal|AvailabilityMacros|AvailabilityVersions|CFAvailability|MJGAvailability)\.h$/
+                }
+
+                # Closes the innermost open source file.
+                function leave() {
+                    printf "F\t%s\t%d\n", stack[n], self[n]
+                    if (availability(header[n]))
+                        preprocessing[header[n]] += self[n]
+                    n--
+                }
+
+                $1 == "ExecuteCompiler" { total = $3 ; compiler = 1 }
+
+                $1 == "Source" {
+                    while (n > 0 && end[n] <= $2)
+                        leave()
+                    if (n > 0)
+                        self[n] -= $3
+                    else
+                        top += $3
+                    n++
+                    header[n] = base($4)
+                    stack[n] = (n > 1 ? stack[n - 1] : root) ";" header[n]
+                    end[n] = $2 + $3
+                    self[n] = $3
+                    next
+                }
+
+                # Parse and Sema events carry "<file>:<line>:<column>"; nested ones are counted once.
+                $4 ~ /:[0-9]+:[0-9]+$/ {
+                    h = base($4)
+                    if (availability(h) && $2 >= sema_end[h]) {
+                        sema[h] += $3
+                        sema_end[h] = $2 + $3
+                    }
+                }
+
+                BEGIN {
+                    root = tu
+                    sub(/.*\//, "", root)
+                }
+
+                END {
+                    # Not a clang trace, e.g. compile_commands.json next to the objects.
+                    if (!compiler)
+                        exit
+                    while (n > 0)
+                        leave()
+                    printf "F\t%s\t%d\n", root, (total > top ? total - top : 0)
+                    printf "T\t%s\t%d\n", tu, total
+                    for (h in preprocessing)
+                        printf "R\t%s\t%d\t%s\t%d\t%d\n", tu, total, h,
+                            (preprocessing[h] > sema[h] ? preprocessing[h] - sema[h] : 0), sema[h]
+                }'
+    done
+    exit 0
+fi
+
+if [ $# -eq 0 ]; then
+    sed -n '8s/^# //p' "$0" >&2
+    exit 1
+fi
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+for INPUT in "$@" ; do
+    if [ -d "$INPUT" ]; then
+        find "$INPUT" -name '*.json' -print0
+    else
+        printf '%s\0' "$INPUT"
+    fi
+done | xargs -0 -P "$JOBS" -n 16 "$0" $STREAM -W > "${WORK}/events"
+
+if [ -n "$FOLDED" ]; then
+    awk -F '\t' '$1 == "F" && $3 > 0 { self[$2] += $3 } END { for (s in self) print s, self[s] }' \
+        "${WORK}/events" | LC_ALL=C sort > "$FOLDED"
+fi
+
+awk -F '\t' -v top="$TOP" '
+    $1 == "T" { build += $3 ; tus++ }
+    $1 != "R" { next }
+    {
+        if (!($2 in total)) {
+            total[$2] = $3
+        }
+        spent[$2] += $5 + $6
+        preprocessing[$4] += $5
+        sema[$4] += $6
+        seen[$4]++
+        all += $5 + $6
+    }
+    END {
+        if (!tus) {
+            print "No -ftime-trace events found" > "/dev/stderr"
+            exit 1
+        }
+        printf "%-40s %10s %16s %7s\n", "TU", "total(ms)", "availability(ms)", "share"
+        count = 0
+        for (tu in spent)
+            order[++count] = tu
+        # Selection of the TOP most affected TUs, without relying on asort.
+        for (i = 1; i <= count && i <= top; i++) {
+            best = i
+            for (j = i + 1; j <= count; j++)
+                if (spent[order[j]] > spent[order[best]])
+                    best = j
+            tu = order[best]
+            order[best] = order[i]
+            order[i] = tu
+            name = tu
+            sub(/.*\//, "", name)
+            printf "%-40s %10.1f %16.1f %6.1f%%\n", name, total[tu] / 1000, spent[tu] / 1000,
+                total[tu] ? spent[tu] * 100 / total[tu] : 0
+        }
+        if (count > top)
+            printf "... %d more TUs\n", count - top
+        printf "\n%-24s %6s %18s %10s %7s\n", "header", "TUs", "preprocessing(ms)", "sema(ms)", "share"
+        for (h in seen)
+            printf "%-24s %6d %18.1f %10.1f %6.1f%%\n", h, seen[h], preprocessing[h] / 1000, sema[h] / 1000,
+                build ? (preprocessing[h] + sema[h]) * 100 / build : 0
+        printf "\n%d TUs, %.1f ms of %.1f ms compile time in availability headers (%.1f%%)\n",
+            tus, all / 1000, build / 1000, build ? all * 100 / build : 0
+    }' "${WORK}/events"